@@ -0,0 +1,394 @@
+/**
+ * \file	dbasc.c
+ * \brief	Compiles a program to C, as a `delta_SStaticImage` for `delta_AttachImage`
+ * \date	17 oct 2026
+ * \author	Reklov
+ */
+#ifdef __DELTABASIC_DBASC__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#include "deltabasic.h"
+#include "dstate.h"
+#include "dstring.h"
+#include "dcompiler.h"
+#include "dimage.h"
+
+#define DBASC_MAX_NAME_SIZE									64
+
+// ******************************************************************************** //
+
+/**
+ * Input of `ReadFile`
+ */
+static FILE* pLoadFile = NULL;
+
+/**
+ * ReadFile
+ */
+static size_t		ReadFile(void* pData, size_t size, size_t count);
+
+/**
+ * Register `spec` as a C function so the program compiles, `NAME:ARGS:RET` with
+ * `n` or `s` for each argument and the return
+ */
+static delta_TBool	DeclareCFunction(delta_SState* D, const char spec[]);
+
+/**
+ * Body of the declared C functions, never called
+ */
+static delta_EStatus DeclaredCFunction(delta_SState* D);
+
+/**
+ * Prefix of the generated symbols from `path`, its file name without extension
+ */
+static void			MakeName(const char path[], char name[DBASC_MAX_NAME_SIZE]);
+
+/**
+ * Write `str` as a C string literal
+ */
+static void			WriteString(FILE* file, const delta_TChar str[], size_t size);
+
+/**
+ * Write `number` as a C constant, exactly
+ */
+static void			WriteNumber(FILE* file, delta_TNumber number);
+
+/**
+ * Write the compiled program of `D` as C, `name` prefixes its symbols
+ */
+static void			WriteImage(FILE* file, delta_SState* D, const char source[], const char name[]);
+
+// ******************************************************************************** //
+
+/**
+ * main
+ */
+int main(int argc, char* argv[]) {
+	const char* path = NULL;
+	const char* outPath = NULL;
+	const char* name = NULL;
+	unsigned int flags = DELTA_STATE_DEFAULT;
+
+	delta_SState* D = NULL;
+	for (int pass = 0; pass < 2; ++pass) { // C functions are declared once the flags are known
+		for (int i = 1; i < argc; ++i) {
+			if ((strcmp(argv[i], "-o") == 0) && (i + 1 < argc))
+				outPath = argv[++i];
+			else if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+				name = argv[++i];
+			else if ((strcmp(argv[i], "-f") == 0) && (i + 1 < argc)) {
+				++i;
+				if ((pass == 1) && (DeclareCFunction(D, argv[i]) == dfalse)) {
+					printf("Bad C function: \"%s\", expected NAME:ARGS:RET like SHOUT:s:s\n", argv[i]);
+					delta_ReleaseState(D);
+
+					return -1;
+				}
+			}
+			else if (strcmp(argv[i], "--register") == 0)
+				flags |= DELTA_STATE_REGISTER_VM;
+			else
+				path = argv[i];
+		}
+
+		if (pass == 0) {
+			if ((path == NULL) || (outPath == NULL)) {
+				printf("Usage: dbasc prog.bas -o prog.c [-n name] [-f NAME:ARGS:RET]... [--register]\n");
+				return -1;
+			}
+
+			D = delta_CreateStateEx(NULL, NULL, flags);
+			if (D == NULL) {
+				printf("Can't create state\n");
+				return -1;
+			}
+		}
+	}
+
+	pLoadFile = fopen(path, "rt");
+	if (pLoadFile == NULL) {
+		printf("Can't open file: \"%s\"\n", path);
+		delta_ReleaseState(D);
+
+		return -1;
+	}
+
+	const delta_EStatus loadStatus = delta_Load(D, ReadFile);
+	fclose(pLoadFile);
+
+	if (loadStatus != DELTA_OK) {
+		printf("can't load code. Abort\n");
+		delta_ReleaseState(D);
+
+		return -1;
+	}
+
+	if (delta_Compile(D) != DELTA_OK) {
+		printf("can't compile code (ERROR IN %zu). Abort\n", D->lineNumber);
+		delta_ReleaseState(D);
+
+		return -1;
+	}
+
+	char defaultName[DBASC_MAX_NAME_SIZE];
+	if (name == NULL) {
+		MakeName(outPath, defaultName);
+		name = defaultName;
+	}
+
+	FILE* file = fopen(outPath, "wt");
+	if (file == NULL) {
+		printf("Can't open file: \"%s\"\n", outPath);
+		delta_ReleaseState(D);
+
+		return -1;
+	}
+
+	WriteImage(file, D, path, name);
+	const int error = ferror(file);
+	fclose(file);
+	delta_ReleaseState(D);
+
+	if (error != 0) {
+		printf("can't write \"%s\". Abort\n", outPath);
+		return -1;
+	}
+
+	return 0;
+}
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * ReadFile
+ */
+size_t ReadFile(void* pData, size_t size, size_t count) {
+	return fread(pData, size, count, pLoadFile);
+}
+
+/* ****************************************
+ * DeclareCFunction
+ */
+delta_TBool DeclareCFunction(delta_SState* D, const char spec[]) {
+	const char* args = strchr(spec, ':');
+	if (args == NULL)
+		return dfalse;
+
+	const char* ret = strchr(args + 1, ':');
+	if ((ret == NULL) || (ret[1] == '\0') || (ret[2] != '\0'))
+		return dfalse;
+
+	const size_t nameSize = args - spec;
+	const size_t argCount = ret - (args + 1);
+	if ((nameSize == 0) || (nameSize >= DBASC_MAX_NAME_SIZE) || (argCount > DELTABASIC_CFUNC_MAX_ARGS))
+		return dfalse;
+
+	char name[DBASC_MAX_NAME_SIZE];
+	memcpy(name, spec, nameSize);
+	name[nameSize] = '\0';
+
+	delta_ECFuncArgType argsType[DELTABASIC_CFUNC_MAX_ARGS + 1];
+	for (size_t i = 0; i <= argCount; ++i) {
+		const char type = (i < argCount) ? args[1 + i] : ret[1];
+		if (type == 'n')
+			argsType[i] = DELTA_CFUNC_ARG_NUMERIC;
+		else if (type == 's')
+			argsType[i] = DELTA_CFUNC_ARG_STRING;
+		else
+			return dfalse;
+	}
+
+	return (delta_RegisterCFunction(D, name, argsType, argCount, argsType[argCount], DeclaredCFunction) == DELTA_OK);
+}
+
+/* ****************************************
+ * DeclaredCFunction
+ */
+delta_EStatus DeclaredCFunction(delta_SState* D) {
+	return DELTA_FUNC_CALLED_OUTSIDE_CFUNC;
+}
+
+/* ****************************************
+ * MakeName
+ */
+void MakeName(const char path[], char name[DBASC_MAX_NAME_SIZE]) {
+	const char* start = strrchr(path, '/');
+	start = (start != NULL) ? start + 1 : path;
+
+	size_t size = 0;
+	if (isdigit((unsigned char)*start))
+		name[size++] = '_';
+
+	for (const char* c = start; (*c != '\0') && (*c != '.') && (size < DBASC_MAX_NAME_SIZE - 1); ++c)
+		name[size++] = isalnum((unsigned char)*c) ? *c : '_';
+
+	name[size] = '\0';
+	if (size == 0)
+		strcpy(name, "program");
+}
+
+/* ****************************************
+ * WriteString
+ */
+void WriteString(FILE* file, const delta_TChar str[], size_t size) {
+	fputc('"', file);
+	for (size_t i = 0; i < size; ++i) {
+		const unsigned char c = (unsigned char)str[i];
+		if ((c == '"') || (c == '\\'))
+			fprintf(file, "\\%c", c);
+		else if ((c < ' ') || (c > '~'))
+			fprintf(file, "\\%03o", c); // Always three digits, the next character can't extend it
+		else
+			fputc(c, file);
+	}
+	fputc('"', file);
+}
+
+/* ****************************************
+ * WriteNumber
+ */
+void WriteNumber(FILE* file, delta_TNumber number) {
+	if (isnan(number))
+		fprintf(file, "(0.0 / 0.0)");
+	else if (isinf(number))
+		fprintf(file, (number > 0) ? "(1.0 / 0.0)" : "(-1.0 / 0.0)");
+	else
+		fprintf(file, "%a", (double)number);
+}
+
+/* ****************************************
+ * WriteImage
+ */
+void WriteImage(FILE* file, delta_SState* D, const char source[], const char name[]) {
+	fprintf(file, "/* Generated by dbasc from %s, do not edit */\n", source);
+	fprintf(file, "#include \"deltabasic.h\"\n\n");
+
+	// Segments back to back, without the ones left by replaced lines
+	size_t bytecodeSize = 0;
+	for (delta_SLine* line = D->head; line != NULL; line = line->next)
+		bytecodeSize += line->bytecodeSize;
+
+	if (bytecodeSize != 0) {
+		fprintf(file, "static const unsigned char %s_bytecode[%zu] = {", name, bytecodeSize);
+
+		for (delta_SLine* line = D->head; line != NULL; line = line->next) {
+			fprintf(file, "\n\t/* %zu */", line->line);
+			for (size_t i = 0; i < line->bytecodeSize; ++i) {
+				if ((i % 16) == 0)
+					fprintf(file, "\n\t");
+
+				fprintf(file, "0x%02x,", D->bytecode[line->offset + i]);
+			}
+		}
+
+		fprintf(file, "\n};\n\n");
+	}
+
+	if (D->head != NULL) {
+		fprintf(file, "static const delta_SStaticImageLine %s_lines[%zu] = {\n", name, D->lineVector.size);
+
+		size_t offset = 0;
+		for (delta_SLine* line = D->head; line != NULL; line = line->next) {
+			fprintf(file, "\t{ %zu, %zu, %zu, ", line->line, offset, line->bytecodeSize);
+			WriteString(file, line->str, delta_Strlen(line->str));
+			fprintf(file, " },\n");
+
+			offset += line->bytecodeSize;
+		}
+
+		fprintf(file, "};\n\n");
+	}
+
+	if (D->registerConstants.size != 0) {
+		fprintf(file, "static const delta_TNumber %s_registerConstants[%zu] = {\n", name, D->registerConstants.size);
+		for (size_t i = 0; i < D->registerConstants.size; ++i) {
+			fprintf(file, "\t");
+			WriteNumber(file, D->registerConstants.values[i]);
+			fprintf(file, ",\n");
+		}
+
+		fprintf(file, "};\n\n");
+	}
+
+	if (D->stringConstants.size != 0) {
+		fprintf(file, "static const delta_TChar* const %s_stringConstants[%zu] = {\n", name, D->stringConstants.size);
+		for (size_t i = 0; i < D->stringConstants.size; ++i) {
+			const delta_UStringValue* constant = &(D->stringConstants.strings[i]);
+
+			fprintf(file, "\t");
+			WriteString(file, DELTA_STRING_DATA(constant), DELTA_STRING_SIZE(constant));
+			fprintf(file, ",\n");
+		}
+
+		fprintf(file, "};\n\n");
+	}
+
+	if (D->numericSlots.size != 0) {
+		fprintf(file, "static const delta_TChar* const %s_numericVariables[%zu] = {\n", name, D->numericSlots.size);
+		for (size_t i = 0; i < D->numericSlots.size; ++i) {
+			const delta_TChar* variable = D->numericSlots.variables[i]->name;
+
+			fprintf(file, "\t");
+			WriteString(file, variable, delta_Strlen(variable));
+			fprintf(file, ",\n");
+		}
+
+		fprintf(file, "};\n\n");
+	}
+
+	if (D->stringSlots.size != 0) {
+		fprintf(file, "static const delta_TChar* const %s_stringVariables[%zu] = {\n", name, D->stringSlots.size);
+		for (size_t i = 0; i < D->stringSlots.size; ++i) {
+			const delta_TChar* variable = D->stringSlots.variables[i]->name;
+
+			fprintf(file, "\t");
+			WriteString(file, variable, delta_Strlen(variable));
+			fprintf(file, ",\n");
+		}
+
+		fprintf(file, "};\n\n");
+	}
+
+	if (D->cfuncVector.size != 0) {
+		fprintf(file, "static const delta_SStaticImageCFunction %s_cfunctions[%zu] = {\n", name, D->cfuncVector.size);
+		for (size_t i = 0; i < D->cfuncVector.size; ++i) {
+			const delta_SCFunction* func = D->cfuncVector.array[i];
+
+			fprintf(file, "\t{ ");
+			WriteString(file, func->name, delta_Strlen(func->name));
+			fprintf(file, ", %u, 0x%02x, %s },\n", func->argCount, func->argsMask,
+				(func->retType == DELTA_CFUNC_ARG_STRING) ? "DELTA_CFUNC_ARG_STRING" : "DELTA_CFUNC_ARG_NUMERIC");
+		}
+
+		fprintf(file, "};\n\n");
+	}
+
+	#define DBASC_SECTION(section, count) {										\
+			if ((count) != 0)														\
+				fprintf(file, "\t%s_%s, %zu,\n", name, section, (size_t)(count));	\
+			else																	\
+				fprintf(file, "\tNULL, 0,\n");										\
+		}
+
+	fprintf(file, "const delta_SStaticImage %s_image = {\n", name);
+	fprintf(file, "\t%u,\n", DELTA_IMAGE_VERSION);
+	DBASC_SECTION("bytecode", bytecodeSize);
+	DBASC_SECTION("lines", D->lineVector.size);
+	DBASC_SECTION("registerConstants", D->registerConstants.size);
+	DBASC_SECTION("stringConstants", D->stringConstants.size);
+	DBASC_SECTION("numericVariables", D->numericSlots.size);
+	DBASC_SECTION("stringVariables", D->stringSlots.size);
+	DBASC_SECTION("cfunctions", D->cfuncVector.size);
+	fprintf(file, "};\n");
+
+	#undef DBASC_SECTION
+}
+
+// ******************************************************************************** //
+
+#endif /* __DELTABASIC_DBASC__ */
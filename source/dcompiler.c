@@ -7,10 +7,14 @@
 #include "dcompiler.h"
 
 #include <string.h>
+#include <math.h>
 
+#include "dimage.h"
 #include "dlexer.h"
 #include "dmemory.h"
 #include "dopcodes.h"
+#include "dregister.h"
+#include "dverifier.h"
 
 #define DELTABASIC_COMPILER_MATH_WINDOW_SIZE				3
 
@@ -42,10 +46,88 @@ static delta_TBool	PushBytecodeDWord(delta_SState* D, delta_SBytecode* BC, delta
  */
 static delta_TBool	PushBytecodeNumber(delta_SState* D, delta_SBytecode* BC, delta_TNumber number);
 
+// ******************************************************************************** //
+
+/**
+ * Make the positions of the return and `FOR` stacks in program lines relative to their line,
+ * or absolute again once the lines are compiled, so a program compiled while it runs goes on
+ */
+static void			RebaseStacks(delta_SState* D, delta_TBool bRelative);
+
+// ******************************************************************************** //
+
+/**
+ * Resolve numeric variable `name`
+ */
+static delta_TBool	FindNumericSlot(delta_SState* D, delta_SLexerState* L, delta_SLexemString name, delta_TWord* slot);
+
+/**
+ * Resolve string variable `name` and push its slot
+ */
+static delta_TBool	PushStringSlot(delta_SState* D, delta_SLexerState* L, delta_SBytecode* BC, delta_SLexemString name);
+
+/**
+ * Push `opcode` storing into numeric variable `name`
+ */
+static delta_TBool	PushNumericStore(delta_SState* D, delta_SLexerState* L, delta_SBytecode* BC, delta_TByte opcode, delta_SLexemString name);
+
+/**
+ * Push the read of numeric variable `name`
+ */
+static delta_TBool	PushNumericLoad(delta_SState* D, delta_SLexerState* L, delta_SBytecode* BC, delta_SLexemString name);
+
+/**
+ * Store the string on top of the stack in `name`. A concatenation just before is fused
+ * into `OPCODE_APPENDS`
+ */
+static delta_TBool	PushStringStore(delta_SState* D, delta_SLexerState* L, delta_SBytecode* BC, delta_SLexemString name);
+
+/**
+ * Intern the literal and push `OPCODE_PUSHS` with its index
+ */
+static delta_TBool	PushStringConstant(delta_SState* D, delta_SLexerState* L, delta_SBytecode* BC, delta_SLexemString str);
+
+// ******************************************************************************** //
+
+/**
+ * If [`start`; `end`) is a single `OPCODE_PUSHN`, read its number
+ */
+static delta_TBool	GetConstant(const delta_SBytecode* BC, size_t start, size_t end, delta_TNumber* number);
+
+/**
+ * Push math `opcode` on the operands starting at `left` and `right`.
+ * Folds it into a single `OPCODE_PUSHN` if both operands are constants
+ */
+static delta_TBool	PushMathOperation(delta_SState* D, delta_SBytecode* BC, delta_EOpcodes opcode, size_t left, size_t right);
+
+/**
+ * Compile-time counterpart of the VM arithmetic and comparison opcodes
+ */
+static delta_TBool	EvaluateMathOperation(delta_EOpcodes opcode, delta_TNumber a, delta_TNumber b, delta_TNumber* result);
+
+// ******************************************************************************** //
+
+/**
+ * Compile every program line into `BC`
+ */
+static delta_EStatus CompileLines(delta_SState* D, delta_SBytecode* BC);
+
+/**
+ * `delta_CompileLine` the segment of `node` at `BC->index`, and set its size and the constants it added
+ */
+static delta_EStatus CompileSegment(delta_SState* D, delta_SLine* node, delta_SBytecode* BC);
+
+/**
+ * Append the segments of the lines edited since the last compile after `D->bytecodeEnd`
+ *
+ * \return `dfalse` if the program has to be compiled again as a whole
+ */
+static delta_TBool	CompileChangedLines(delta_SState* D);
+
 /**
- * ExpandBytecodeBuffer
+ * `delta_Link` every line segment, and the exec line with `bExec`
  */
-static delta_TBool	ExpandBytecodeBuffer(delta_SState* D, delta_SBytecode* BC);
+static delta_EStatus LinkLines(delta_SState* D, delta_TBool bExec);
 
 // ******************************************************************************** //
 
@@ -91,41 +173,235 @@ delta_EMathStatus CompileMath(delta_SState* D, delta_SLexerState* L, delta_SByte
 delta_EStatus delta_Compile(delta_SState* D) {
 	if (D->head == NULL) {
 		D->bCompiled = dtrue;
+		delta_VerifyProgram(D);
 		return DELTA_OK;
 	}
 
+	if (D->bAttached == dtrue) { // The program is compiled again into a buffer of its own
+		if (delta_DetachImage(D) == dfalse)
+			return DELTA_ALLOCATOR_ERROR;
+	}
+
+	// Edited while running, from a jump or the exec line: the return and `FOR` stacks point in the bytecode
+	const delta_TBool bRunning = (D->currentLine != NULL);
+	const delta_TBool bExecLive = delta_IsExecLineLive(D); // Its jumps hold line indices too
+
 	D->ip			= 0;
 	D->currentLine	= NULL;
 
-	delta_SBytecode bc;
-	bc.bytecodeSize	= D->bytecodeSize;
-	bc.index		= DELTABASIC_EXEC_BYTECODE_SIZE;
-	bc.bytecode		= D->bytecode;
-	bc.bCanResize	= dtrue;
+	delta_EStatus status = DELTA_OK;
+
+	// Recompile only the edited lines while the segments and the constants of the replaced ones
+	// take less than half of the bytecode and of the constant pools
+	const delta_TBool bIncremental = ((D->bytecodeEnd != 0) &&
+		(D->bytecodeGarbage * 2 <= D->bytecodeEnd) &&
+		(D->constantsGarbage * 2 <= D->stringConstants.size + D->registerConstants.size));
+
+	if ((bIncremental == dfalse) || (CompileChangedLines(D) == dfalse)) {
+		if (bRunning == dtrue)
+			RebaseStacks(D, dtrue);
+
+		delta_SBytecode bc = { 0 };
+		bc.bytecodeSize	= D->bytecodeSize;
+		bc.index		= 0;
+		bc.bytecode		= D->bytecode;
+		bc.bCanResize	= dtrue;
+
+		D->bytecodeEnd		= 0;
+		D->bytecodeGarbage	= 0;
+		D->constantsGarbage	= 0;
+
+		status = CompileLines(D, &bc);
+
+		D->bytecodeSize	= bc.bytecodeSize;
+		D->bytecode		= bc.bytecode;
 
-	for (delta_SLine* node = D->head; node != NULL; node = node->next) {
-		delta_EStatus status = delta_CompileLine(D, node, NULL, &bc);
 		if (status != DELTA_OK) {
-			D->bytecodeSize = bc.bytecodeSize;
-			D->bytecode = bc.bytecode;
+			if (bRunning == dtrue) { // Can't be resumed
+				D->returnHead	= 0;
+				D->forHead		= 0;
+			}
 
 			return status;
 		}
+
+		D->bytecodeEnd = bc.index;
+
+		if (bRunning == dtrue)
+			RebaseStacks(D, dfalse);
 	}
 
-	if (bc.bytecode[bc.index - 1] != OPCODE_HLT) {
-		PushAssert(PushBytecodeByte(D, &bc, OPCODE_HLT));
+	D->bCompiled	= dtrue; // Before linking, so `delta_Link` doesn't compile again
+
+	status = LinkLines(D, bExecLive);
+
+	if (status != DELTA_OK) {
+		D->bCompiled	= dfalse;
+		D->bytecodeEnd	= 0;
+		return status;
 	}
 
-	D->bytecodeSize	= bc.bytecodeSize;
-	D->bytecode		= bc.bytecode;
-	D->ip			= DELTABASIC_EXEC_BYTECODE_SIZE;
+	delta_VerifyProgram(D); // Stack depths of the new program, see `D->verification`
+
+	D->ip			= D->head->offset;
 	D->currentLine	= D->head;
-	D->bCompiled	= dtrue;
 
 	return DELTA_OK;
 }
 
+/* ****************************************
+ * delta_Link
+ */
+delta_EStatus delta_Link(delta_SState* D, delta_TByte* bytecode, size_t begin, size_t end) {
+	size_t ip = begin;
+	while (ip < end) {
+		const delta_TByte opcode = bytecode[ip];
+		const size_t size = delta_GetOpcodeSize(opcode);
+		if (size == 0)
+			return DELTA_MACHINE_UNKNOWN_OPCODE;
+
+		if ((opcode == OPCODE_JMP) || (opcode == OPCODE_GOSUB)) {
+			if (D->bCompiled == dfalse) { // Jump from the exec line to a program that has been edited
+				StatusAssert(delta_Compile(D));
+			}
+
+			delta_TDWord* operands = (delta_TDWord*)(bytecode + ip + 1);
+
+			size_t index = 0;
+			if (delta_FindJumpTarget(D, operands[0], &index) == dfalse)
+				return DELTA_OUT_OF_LINES_RANGE;
+
+			operands[1] = (delta_TDWord)index;
+		}
+
+		ip += size;
+	}
+
+	return DELTA_OK;
+}
+
+/* ****************************************
+ * delta_FindJumpTarget
+ */
+delta_TBool delta_FindJumpTarget(const delta_SState* D, size_t number, size_t* index) {
+	if (delta_FindLine(D, number, index) == dtrue)
+		return dtrue;
+
+	if ((*index == 0) || (*index == D->lineVector.size))
+		return dfalse;
+
+	--(*index);
+	return dtrue;
+}
+
+/* ****************************************
+ * delta_Optimize
+ */
+delta_EStatus delta_Optimize(delta_SBytecode* BC, size_t begin) {
+	delta_TByte* const bytecode = BC->bytecode;
+	const size_t end = BC->index;
+
+	size_t read = begin;
+	size_t write = begin;
+	while (read < end) {
+		const delta_TByte* in = bytecode + read;
+		delta_TByte* out = bytecode + write;
+		const size_t left = end - read;
+
+		// GETN a; PUSHN c; ADD|SUB; SETN a -> INCN a, (+|-)c
+		if ((left >= 12) && (in[0] == OPCODE_GETN) && (in[3] == OPCODE_PUSHN) &&
+			((in[8] == OPCODE_ADD) || (in[8] == OPCODE_SUB)) && (in[9] == OPCODE_SETN) &&
+			(*((delta_TWord*)(in + 1)) == *((delta_TWord*)(in + 10)))) {
+			const delta_TWord slot = *((delta_TWord*)(in + 1));
+			delta_TNumber number = *((delta_TNumber*)(in + 4));
+			if (in[8] == OPCODE_SUB)
+				number = -number;
+
+			out[0] = OPCODE_INCN;
+			*((delta_TWord*)(out + 1)) = slot;
+			*((delta_TNumber*)(out + 3)) = number;
+
+			read += 12;
+			write += 7;
+		}
+		// GETN a; PUSHN c; <comparison>; JNLNZ -> JNLNC a, <comparison>, c
+		else if ((left >= 10) && (in[0] == OPCODE_GETN) && (in[3] == OPCODE_PUSHN) &&
+			(in[8] >= OPCODE_ET) && (in[8] <= OPCODE_GET) && (in[9] == OPCODE_JNLNZ)) {
+			const delta_TWord slot = *((delta_TWord*)(in + 1));
+			const delta_TNumber number = *((delta_TNumber*)(in + 4));
+			const delta_TByte comparison = in[8];
+
+			out[0] = OPCODE_JNLNC;
+			*((delta_TWord*)(out + 1)) = slot;
+			out[3] = comparison;
+			*((delta_TNumber*)(out + 4)) = number;
+
+			read += 10;
+			write += 8;
+		}
+		// GETN a; GETN b; <comparison>; JNLNZ -> JNLNN a, <comparison>, b
+		else if ((left >= 8) && (in[0] == OPCODE_GETN) && (in[3] == OPCODE_GETN) &&
+			(in[6] >= OPCODE_ET) && (in[6] <= OPCODE_GET) && (in[7] == OPCODE_JNLNZ)) {
+			const delta_TWord slotA = *((delta_TWord*)(in + 1));
+			const delta_TWord slotB = *((delta_TWord*)(in + 4));
+			const delta_TByte comparison = in[6];
+
+			out[0] = OPCODE_JNLNN;
+			*((delta_TWord*)(out + 1)) = slotA;
+			out[3] = comparison;
+			*((delta_TWord*)(out + 4)) = slotB;
+
+			read += 8;
+			write += 6;
+		}
+		// PUSHN c; SETN a -> SETNC a, c
+		else if ((left >= 8) && (in[0] == OPCODE_PUSHN) && (in[5] == OPCODE_SETN)) {
+			const delta_TNumber number = *((delta_TNumber*)(in + 1));
+			const delta_TWord slot = *((delta_TWord*)(in + 6));
+
+			out[0] = OPCODE_SETNC;
+			*((delta_TWord*)(out + 1)) = slot;
+			*((delta_TNumber*)(out + 3)) = number;
+
+			read += 8;
+			write += 7;
+		}
+		// GETN a; PRINTN|PRINTNT -> PRINTVN|PRINTVNT a
+		// GETS a; PRINTS|PRINTST -> PRINTVS|PRINTVST a
+		else if ((left >= 4) &&
+			(((in[0] == OPCODE_GETN) && ((in[3] == OPCODE_PRINTN) || (in[3] == OPCODE_PRINTNT))) ||
+			((in[0] == OPCODE_GETS) && ((in[3] == OPCODE_PRINTS) || (in[3] == OPCODE_PRINTST))))) {
+			const delta_TWord slot = *((delta_TWord*)(in + 1));
+			delta_TByte opcode = OPCODE_PRINTVN;
+			switch (in[3]) {
+				case OPCODE_PRINTNT:	opcode = OPCODE_PRINTVNT; break;
+				case OPCODE_PRINTS:		opcode = OPCODE_PRINTVS; break;
+				case OPCODE_PRINTST:	opcode = OPCODE_PRINTVST; break;
+			}
+
+			out[0] = opcode;
+			*((delta_TWord*)(out + 1)) = slot;
+
+			read += 4;
+			write += 3;
+		}
+		else {
+			const size_t size = delta_GetOpcodeSize(in[0]);
+			if ((size == 0) || (size > left))
+				return DELTA_MACHINE_UNKNOWN_OPCODE;
+
+			if (write != read)
+				memmove(out, in, size);
+
+			read += size;
+			write += size;
+		}
+	}
+
+	BC->index = write;
+	return DELTA_OK;
+}
+
 /* ****************************************
  * delta_CompileLine
  */
@@ -133,6 +409,11 @@ delta_EStatus delta_CompileLine(delta_SState* D, delta_SLine* L, delta_TChar* st
 	D->lineNumber = L->line;
 	L->offset = BC->index;
 
+	if (BC->bExec == dtrue)
+		delta_ClearStringConstants(D, &(D->execStringConstants), dfalse);
+
+	BC->lastConcat = SIZE_MAX;
+
 	delta_SLexerState lexem = { 0 };
 	lexem.buffer = (str == NULL) ? L->str : str;
 
@@ -155,6 +436,14 @@ delta_EStatus delta_CompileLine(delta_SState* D, delta_SLine* L, delta_TChar* st
 			return DELTA_SYNTAX_ERROR;
 	}
 
+#if (DELTABASIC_COMPILER_PEEPHOLE != 0)
+	StatusAssert(delta_Optimize(BC, L->offset));
+#endif
+
+	if ((D->flags & DELTA_STATE_REGISTER_VM) != 0) {
+		StatusAssert(delta_TranslateRegisters(D, BC, L->offset, BC->bExec));
+	}
+
 	PushAssert(PushBytecodeByte(D, BC, OPCODE_NEXTL));
 	return DELTA_OK;
 }
@@ -220,9 +509,7 @@ delta_EStatus CompileInstruction(delta_SState* D, delta_SLexerState* L, delta_SB
 				if (L->symbol == '=') { // String Assignment
 					MathStatusAssert(CompileMath(D, L, BC, MATH_OK_STRING), MATH_OK_STRING);
 
-					PushAssert(PushBytecodeByte(D, BC, OPCODE_SETS));
-					PushAssert(PushBytecodeWord(D, BC, name.offset));
-					PushAssert(PushBytecodeWord(D, BC, name.size));
+					PushAssert(PushStringStore(D, L, BC, name));
 				}
 				else
 					return DELTA_SYNTAX_ERROR;
@@ -230,9 +517,7 @@ delta_EStatus CompileInstruction(delta_SState* D, delta_SLexerState* L, delta_SB
 			else if (L->symbol == '=') { // Numeric Assignment
 				MathStatusAssert(CompileMath(D, L, BC, MATH_OK_NUMERIC), MATH_OK_NUMERIC);
 
-				PushAssert(PushBytecodeByte(D, BC, OPCODE_SETN));
-				PushAssert(PushBytecodeWord(D, BC, name.offset));
-				PushAssert(PushBytecodeWord(D, BC, name.size));
+				PushAssert(PushNumericStore(D, L, BC, OPCODE_SETN, name));
 			}
 			else
 				return DELTA_SYNTAX_ERROR;
@@ -338,10 +623,12 @@ delta_EStatus CompileInstruction(delta_SState* D, delta_SLexerState* L, delta_SB
 				else if ((L->type == LEXEM_NAME) || (L->type == LEXEM_EOL)) // Numeric
 					status = MATH_OK_NUMERIC;
 
-				if (status != MATH_OK_UNDEF) {
-					PushAssert(PushBytecodeByte(D, BC, (status == MATH_OK_NUMERIC) ? OPCODE_INPUTN : OPCODE_INPUTS));
-					PushAssert(PushBytecodeWord(D, BC, name.offset));
-					PushAssert(PushBytecodeWord(D, BC, name.size));
+				if (status == MATH_OK_NUMERIC) {
+					PushAssert(PushNumericStore(D, L, BC, OPCODE_INPUTN, name));
+				}
+				else if (status == MATH_OK_STRING) {
+					PushAssert(PushBytecodeByte(D, BC, OPCODE_INPUTS));
+					PushAssert(PushStringSlot(D, L, BC, name));
 				}
 			}
 		}
@@ -358,29 +645,15 @@ delta_EStatus CompileInstruction(delta_SState* D, delta_SLexerState* L, delta_SB
 			if (L->integerValue < 0)
 				return DELTA_SYNTAX_ERROR;
 
-			size_t number = (size_t)(L->integerValue);
-			delta_SLine* line = D->head;
-			while (line != NULL) {
-				if (line->line == number)
-					break;
-
-				if (line->line > number) {
-					if (line->prev != NULL)
-						line = line->prev;
-					else
-						line = NULL;
-
-					break;
-				}
-
-				line = line->next;
-			}
-
-			if (line == NULL)
+			const size_t number = (size_t)(L->integerValue);
+			size_t index = 0;
+			if (delta_FindJumpTarget(D, number, &index) == dfalse)
 				return DELTA_OUT_OF_LINES_RANGE;
-			
+
+			// The line number as written, `delta_Link` resolves the line index again after edits
 			PushAssert(PushBytecodeByte(D, BC, (bGoto == dtrue) ? OPCODE_JMP : OPCODE_GOSUB));
-			PushAssert(PushBytecodeWord(D, BC, (delta_TWord)(line->line)));
+			PushAssert(PushBytecodeDWord(D, BC, (delta_TDWord)number));
+			PushAssert(PushBytecodeDWord(D, BC, 0));
 		}
 		else if (L->op == OP_IF) {
 			MathStatusAssert(CompileMath(D, L, BC, MATH_OK_NUMERIC), MATH_OK_NUMERIC);
@@ -419,9 +692,7 @@ delta_EStatus CompileInstruction(delta_SState* D, delta_SLexerState* L, delta_SB
 			MathStatusAssert(CompileMath(D, L, BC, MATH_OK_NUMERIC), MATH_OK_NUMERIC); // FOR var = math TO math
 
 			if ((L->type == LEXEM_EOL) || ((L->type == LEXEM_SYMBOL) && (L->symbol == ':'))) {
-				PushAssert(PushBytecodeByte(D, BC, OPCODE_SETFOR));
-				PushAssert(PushBytecodeWord(D, BC, name.offset));
-				PushAssert(PushBytecodeWord(D, BC, name.size));
+				PushAssert(PushNumericStore(D, L, BC, OPCODE_SETFOR, name));
 			}
 			else if (L->type == LEXEM_OP) {
 				if (L->op != OP_STEP) // FOR var = math TO math STEP
@@ -429,9 +700,7 @@ delta_EStatus CompileInstruction(delta_SState* D, delta_SLexerState* L, delta_SB
 
 				MathStatusAssert(CompileMath(D, L, BC, MATH_OK_NUMERIC), MATH_OK_NUMERIC); // FOR var = math TO math STEP math
 
-				PushAssert(PushBytecodeByte(D, BC, OPCODE_SETSTEPFOR));
-				PushAssert(PushBytecodeWord(D, BC, name.offset));
-				PushAssert(PushBytecodeWord(D, BC, name.size));
+				PushAssert(PushNumericStore(D, L, BC, OPCODE_SETSTEPFOR, name));
 			}
 			else
 				return DELTA_SYNTAX_ERROR;
@@ -467,9 +736,7 @@ delta_EStatus CompileInstruction(delta_SState* D, delta_SLexerState* L, delta_SB
 			if (L->symbol == '=') { // String Assignment
 				MathStatusAssert(CompileMath(D, L, BC, MATH_OK_STRING), MATH_OK_STRING);
 
-				PushAssert(PushBytecodeByte(D, BC, OPCODE_SETS));
-				PushAssert(PushBytecodeWord(D, BC, name.offset));
-				PushAssert(PushBytecodeWord(D, BC, name.size));
+				PushAssert(PushStringStore(D, L, BC, name));
 			}
 			else if (L->symbol == '(') { // String Function call or String Array
 				size_t index;
@@ -501,9 +768,7 @@ delta_EStatus CompileInstruction(delta_SState* D, delta_SLexerState* L, delta_SB
 		else if (L->symbol == '=') { // Numeric Assignment
 			MathStatusAssert(CompileMath(D, L, BC, MATH_OK_NUMERIC), MATH_OK_NUMERIC);
 
-			PushAssert(PushBytecodeByte(D, BC, OPCODE_SETN));
-			PushAssert(PushBytecodeWord(D, BC, name.offset));
-			PushAssert(PushBytecodeWord(D, BC, name.size));
+			PushAssert(PushNumericStore(D, L, BC, OPCODE_SETN, name));
 		}
 		else if (L->symbol == '(') { // Numeric Function call or Numeric Array
 			size_t index;
@@ -609,9 +874,7 @@ delta_EMathStatus CompileMathUnary(delta_SState* D, delta_SLexerState* L, delta_
 
 		*mathStatus = MATH_OK_STRING;
 
-		PushAssert(PushBytecodeByte(D, BC, OPCODE_PUSHS));
-		PushAssert(PushBytecodeWord(D, BC, L->string.offset));
-		PushAssert(PushBytecodeWord(D, BC, L->string.size));
+		PushAssert(PushStringConstant(D, L, BC, L->string));
 
 		return DELTA_OK;
 	}
@@ -656,8 +919,7 @@ delta_EMathStatus CompileMathUnary(delta_SState* D, delta_SLexerState* L, delta_
 				L->head = head;
 
 				PushAssert(PushBytecodeByte(D, BC, OPCODE_GETS));
-				PushAssert(PushBytecodeWord(D, BC, str.offset));
-				PushAssert(PushBytecodeWord(D, BC, str.size));
+				PushAssert(PushStringSlot(D, L, BC, str));
 			}
 		}
 		else {
@@ -682,9 +944,7 @@ delta_EMathStatus CompileMathUnary(delta_SState* D, delta_SLexerState* L, delta_
 			else {
 				L->head = head;
 
-				PushAssert(PushBytecodeByte(D, BC, OPCODE_GETN));
-				PushAssert(PushBytecodeWord(D, BC, str.offset));
-				PushAssert(PushBytecodeWord(D, BC, str.size));
+				PushAssert(PushNumericLoad(D, L, BC, str));
 			}
 
 			if (bMinus == dtrue)
@@ -704,6 +964,7 @@ delta_EMathStatus CompileMath(delta_SState* D, delta_SLexerState* L, delta_SByte
 	delta_EOpcodes ops[DELTABASIC_COMPILER_MAX_MATH_OPS];
 	size_t nOps = 0;
 	size_t outVariables = 0;
+	size_t starts[DELTABASIC_COMPILER_MAX_MATH_OPS + 1]; // Where each operand begins in the bytecode
 
 	delta_EMathStatus mathStatus = startingMathStatus;
 
@@ -711,6 +972,7 @@ delta_EMathStatus CompileMath(delta_SState* D, delta_SLexerState* L, delta_SByte
 	if (L->type == LEXEM_EOL) // Empty
 		return MATH_OK_UNDEF;
 
+	starts[outVariables] = BC->index;
 	StatusAssert(CompileMathUnary(D, L, BC, &mathStatus));
 	++outVariables;
 	ParseAssert();
@@ -771,11 +1033,11 @@ delta_EMathStatus CompileMath(delta_SState* D, delta_SLexerState* L, delta_SByte
 					while (nOps != 0) {
 						const delta_EOpcodes opcodeOnTop = ops[--nOps];
 
-						if (outVariables == 0)
+						if (outVariables < 2)
 							return MATH_NOT_ENOUGH_VALUES;
 
 						--outVariables;
-						PushAssert(PushBytecodeByte(D, BC, opcodeOnTop));
+						PushAssert(PushMathOperation(D, BC, opcodeOnTop, starts[outVariables - 1], starts[outVariables]));
 					}
 				}
 			}
@@ -785,6 +1047,7 @@ delta_EMathStatus CompileMath(delta_SState* D, delta_SLexerState* L, delta_SByte
 
 			ops[nOps++] = opcode;
 
+			starts[outVariables] = BC->index;
 			StatusAssert(CompileMathUnary(D, L, BC, &mathStatus));
 			++outVariables;
 			ParseAssert();
@@ -799,14 +1062,36 @@ delta_EMathStatus CompileMath(delta_SState* D, delta_SLexerState* L, delta_SByte
 			return DELTA_SYNTAX_ERROR;
 	}
 
+	// Chained concatenations are left on the stack and sized once by a single `OPCODE_CONCATN`
+	size_t nConcats = 0;
+	while ((nConcats < nOps) && (ops[nOps - 1 - nConcats] == OPCODE_CONCAT))
+		++nConcats;
+
+	if (nConcats != 0) {
+		if (outVariables < nConcats + 1)
+			return MATH_NOT_ENOUGH_VALUES;
+
+		nOps -= nConcats;
+		outVariables -= nConcats;
+
+		BC->lastConcat = BC->index;
+		if (nConcats == 1) {
+			PushAssert(PushBytecodeByte(D, BC, OPCODE_CONCAT));
+		}
+		else {
+			PushAssert(PushBytecodeByte(D, BC, OPCODE_CONCATN));
+			PushAssert(PushBytecodeByte(D, BC, (delta_TByte)(nConcats + 1)));
+		}
+	}
+
 	while (nOps != 0) {
 		const delta_EOpcodes opcodeOnTop = ops[--nOps];
 
-		if (outVariables == 0)
+		if (outVariables < 2)
 			return MATH_NOT_ENOUGH_VALUES;
 
 		--outVariables;
-		PushAssert(PushBytecodeByte(D, BC, opcodeOnTop));
+		PushAssert(PushMathOperation(D, BC, opcodeOnTop, starts[outVariables - 1], starts[outVariables]));
 	}
 	
 	return mathStatus;
@@ -819,7 +1104,7 @@ delta_EMathStatus CompileMath(delta_SState* D, delta_SLexerState* L, delta_SByte
  */
 delta_TBool PushBytecodeByte(delta_SState* D, delta_SBytecode* BC, delta_TByte byte) {
 	if (BC->index + 1 >= BC->bytecodeSize) {
-		if (ExpandBytecodeBuffer(D, BC) == dfalse)
+		if (delta_ExpandBytecode(D, BC) == dfalse)
 			return dfalse;
 	}
 
@@ -834,7 +1119,7 @@ delta_TBool PushBytecodeByte(delta_SState* D, delta_SBytecode* BC, delta_TByte b
  */
 inline delta_TBool PushBytecodeWord(delta_SState* D, delta_SBytecode* BC, delta_TWord word) {
 	if (BC->index + 2 >= BC->bytecodeSize) {
-		if (ExpandBytecodeBuffer(D, BC) == dfalse)
+		if (delta_ExpandBytecode(D, BC) == dfalse)
 			return dfalse;
 	}
 
@@ -849,7 +1134,7 @@ inline delta_TBool PushBytecodeWord(delta_SState* D, delta_SBytecode* BC, delta_
  */
 inline delta_TBool PushBytecodeDWord(delta_SState* D, delta_SBytecode* BC, delta_TDWord dword) {
 	if (BC->index + 4 >= BC->bytecodeSize) {
-		if (ExpandBytecodeBuffer(D, BC) == dfalse)
+		if (delta_ExpandBytecode(D, BC) == dfalse)
 			return dfalse;
 	}
 
@@ -877,9 +1162,9 @@ inline delta_TBool PushBytecodeNumber(delta_SState* D, delta_SBytecode* BC, delt
 }
 
 /* ****************************************
- * ExpandBytecodeBuffer
+ * delta_ExpandBytecode
  */
-inline delta_TBool ExpandBytecodeBuffer(delta_SState* D, delta_SBytecode* BC) {
+delta_TBool delta_ExpandBytecode(delta_SState* D, delta_SBytecode* BC) {
 	if (BC->bCanResize == dfalse)
 		return dfalse;
 
@@ -887,6 +1172,7 @@ inline delta_TBool ExpandBytecodeBuffer(delta_SState* D, delta_SBytecode* BC) {
 
 	BC->bytecode = DELTA_Realloc(
 		D,
+		DELTA_MEMORY_BYTECODE,
 		BC->bytecode,
 		sizeof(delta_TByte) * BC->bytecodeSize,
 		sizeof(delta_TByte) * newSize
@@ -902,6 +1188,107 @@ inline delta_TBool ExpandBytecodeBuffer(delta_SState* D, delta_SBytecode* BC) {
 
 // ******************************************************************************** //
 
+/* ****************************************
+ * FindNumericSlot
+ */
+delta_TBool FindNumericSlot(delta_SState* D, delta_SLexerState* L, delta_SLexemString name, delta_TWord* slot) {
+	delta_SNumericVariable* var = delta_FindOrAddNumericVariable(D, L->buffer + name.offset, name.size);
+	if ((var == NULL) || (var->slot > UINT16_MAX))
+		return dfalse;
+
+	*slot = (delta_TWord)(var->slot);
+	return dtrue;
+}
+
+/* ****************************************
+ * PushNumericStore
+ */
+delta_TBool PushNumericStore(delta_SState* D, delta_SLexerState* L, delta_SBytecode* BC, delta_TByte opcode, delta_SLexemString name) {
+	delta_TWord slot;
+	if (FindNumericSlot(D, L, name, &slot) == dfalse)
+		return dfalse;
+
+	if (PushBytecodeByte(D, BC, opcode) == dfalse)
+		return dfalse;
+
+	return PushBytecodeWord(D, BC, slot);
+}
+
+/* ****************************************
+ * PushStringStore
+ */
+delta_TBool PushStringStore(delta_SState* D, delta_SLexerState* L, delta_SBytecode* BC, delta_SLexemString name) {
+	delta_TByte count = 0;
+	if ((BC->lastConcat != SIZE_MAX) && (BC->lastConcat + 1 == BC->index) && (BC->bytecode[BC->lastConcat] == OPCODE_CONCAT))
+		count = 2;
+	else if ((BC->lastConcat != SIZE_MAX) && (BC->lastConcat + 2 == BC->index) && (BC->bytecode[BC->lastConcat] == OPCODE_CONCATN))
+		count = BC->bytecode[BC->lastConcat + 1];
+
+	if (count == 0) {
+		if (PushBytecodeByte(D, BC, OPCODE_SETS) == dfalse)
+			return dfalse;
+
+		return PushStringSlot(D, L, BC, name);
+	}
+
+	BC->index = BC->lastConcat;
+	BC->lastConcat = SIZE_MAX;
+
+	if (PushBytecodeByte(D, BC, OPCODE_APPENDS) == dfalse)
+		return dfalse;
+
+	if (PushStringSlot(D, L, BC, name) == dfalse)
+		return dfalse;
+
+	return PushBytecodeByte(D, BC, count);
+}
+
+/* ****************************************
+ * PushStringConstant
+ */
+delta_TBool PushStringConstant(delta_SState* D, delta_SLexerState* L, delta_SBytecode* BC, delta_SLexemString str) {
+	delta_SStringConstants* constants = (BC->bExec == dtrue) ? &(D->execStringConstants) : &(D->stringConstants);
+
+	size_t index = 0;
+	if (delta_AddStringConstant(D, constants, L->buffer + str.offset, str.size, &index) == dfalse)
+		return dfalse;
+
+	if (BC->bExec == dtrue)
+		index |= DELTA_STRING_CONSTANT_EXEC;
+
+	if (PushBytecodeByte(D, BC, OPCODE_PUSHS) == dfalse)
+		return dfalse;
+
+	return PushBytecodeWord(D, BC, (delta_TWord)index);
+}
+
+/* ****************************************
+ * PushNumericLoad
+ */
+delta_TBool PushNumericLoad(delta_SState* D, delta_SLexerState* L, delta_SBytecode* BC, delta_SLexemString name) {
+	delta_TWord slot;
+	if (FindNumericSlot(D, L, name, &slot) == dfalse)
+		return dfalse;
+
+	if (PushBytecodeByte(D, BC, OPCODE_GETN) == dfalse)
+		return dfalse;
+
+	return PushBytecodeWord(D, BC, slot);
+}
+
+/* ****************************************
+ * PushStringSlot
+ */
+delta_TBool PushStringSlot(delta_SState* D, delta_SLexerState* L, delta_SBytecode* BC, delta_SLexemString name) {
+	delta_SStringVariable* var = delta_FindOrAddStringVariable(D, L->buffer + name.offset, name.size);
+	if ((var == NULL) || (var->slot > UINT16_MAX))
+		return dfalse;
+
+	return PushBytecodeWord(D, BC, (delta_TWord)(var->slot));
+}
+
+// ******************************************************************************** //
+
 /* ****************************************
  * GetMathPriority
  */
@@ -927,3 +1314,169 @@ inline size_t GetMathPriority(delta_EOpcodes op) {
 			return 0;
 	}
 }
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * RebaseStacks
+ */
+void RebaseStacks(delta_SState* D, delta_TBool bRelative) {
+	for (size_t i = 0; i < D->returnHead; ++i) {
+		delta_SReturnState* state = &(D->returnStack[i]);
+		if (state->line != D->execLine)
+			state->ip = (bRelative == dtrue) ? (state->ip - state->line->offset) : (state->ip + state->line->offset);
+	}
+
+	for (size_t i = 0; i < D->forHead; ++i) {
+		delta_SForState* state = &(D->forStack[i]);
+		if (state->startLine != D->execLine)
+			state->startIp = (bRelative == dtrue) ? (state->startIp - state->startLine->offset) : (state->startIp + state->startLine->offset);
+	}
+}
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * GetConstant
+ */
+delta_TBool GetConstant(const delta_SBytecode* BC, size_t start, size_t end, delta_TNumber* number) {
+	if ((end - start != 5) || (BC->bytecode[start] != OPCODE_PUSHN))
+		return dfalse;
+
+	union {
+		delta_TNumber number;
+		delta_TDWord dword;
+	} cast;
+
+	cast.dword = *((delta_TDWord*)(BC->bytecode + start + 1));
+	*number = cast.number;
+
+	return dtrue;
+}
+
+/* ****************************************
+ * PushMathOperation
+ */
+delta_TBool PushMathOperation(delta_SState* D, delta_SBytecode* BC, delta_EOpcodes opcode, size_t left, size_t right) {
+	delta_TNumber a;
+	delta_TNumber b;
+	delta_TNumber result;
+
+	if ((GetConstant(BC, left, right, &a) == dtrue) && (GetConstant(BC, right, BC->index, &b) == dtrue)) {
+		if (EvaluateMathOperation(opcode, a, b, &result) == dtrue) {
+			BC->index = left;
+
+			if (PushBytecodeByte(D, BC, OPCODE_PUSHN) == dfalse)
+				return dfalse;
+
+			return PushBytecodeNumber(D, BC, result);
+		}
+	}
+
+	return PushBytecodeByte(D, BC, opcode);
+}
+
+/* ****************************************
+ * EvaluateMathOperation
+ */
+delta_TBool EvaluateMathOperation(delta_EOpcodes opcode, delta_TNumber a, delta_TNumber b, delta_TNumber* result) {
+	switch (opcode) {
+		case OPCODE_ADD:	*result = a + b; break;
+		case OPCODE_SUB:	*result = a - b; break;
+		case OPCODE_MUL:	*result = a * b; break;
+		case OPCODE_DIV:	*result = a / b; break;
+		case OPCODE_MOD:	*result = fmodf(a, b); break;
+		case OPCODE_POW:	*result = powf(a, b); break;
+		case OPCODE_ET:		*result = fabsf(a - b) < DELTABASIC_NUMERIC_EPSILON; break;
+		case OPCODE_NET:	*result = fabsf(a - b) > DELTABASIC_NUMERIC_EPSILON; break;
+		case OPCODE_LT:		*result = a < b; break;
+		case OPCODE_GT:		*result = a > b; break;
+		case OPCODE_LET:	*result = a <= b; break;
+		case OPCODE_GET:	*result = a >= b; break;
+		default:
+			return dfalse;
+	}
+
+	return dtrue;
+}
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * CompileLines
+ */
+delta_EStatus CompileLines(delta_SState* D, delta_SBytecode* BC) {
+	D->registerConstants.size = 0;
+	delta_ClearStringConstants(D, &(D->stringConstants), dfalse);
+
+	for (delta_SLine* node = D->head; node != NULL; node = node->next) {
+		StatusAssert(CompileSegment(D, node, BC));
+	}
+
+	return DELTA_OK;
+}
+
+/* ****************************************
+ * CompileSegment
+ */
+delta_EStatus CompileSegment(delta_SState* D, delta_SLine* node, delta_SBytecode* BC) {
+	const size_t constants = D->stringConstants.size + D->registerConstants.size;
+
+	const delta_EStatus status = delta_CompileLine(D, node, NULL, BC);
+	if (status != DELTA_OK)
+		return status;
+
+	node->bytecodeSize	= BC->index - node->offset;
+	node->constants		= (D->stringConstants.size + D->registerConstants.size) - constants;
+
+	return DELTA_OK;
+}
+
+/* ****************************************
+ * CompileChangedLines
+ */
+delta_TBool CompileChangedLines(delta_SState* D) {
+	delta_SBytecode bc = { 0 };
+	bc.bytecodeSize	= D->bytecodeSize;
+	bc.index		= D->bytecodeEnd;
+	bc.bytecode		= D->bytecode;
+	bc.bCanResize	= dtrue;
+
+	delta_TBool bResult = dtrue;
+	for (size_t i = 0; (i < D->lineVector.size) && (bResult == dtrue); ++i) {
+		delta_SLine* node = D->lineVector.array[i];
+		if (node->bytecodeSize != 0)
+			continue;
+
+		if (CompileSegment(D, node, &bc) != DELTA_OK)
+			bResult = dfalse; // The full compile reports the error
+	}
+
+	D->bytecodeSize	= bc.bytecodeSize;
+	D->bytecode		= bc.bytecode;
+
+	if (bResult == dtrue)
+		D->bytecodeEnd = bc.index;
+
+	return bResult;
+}
+
+/* ****************************************
+ * LinkLines
+ */
+delta_EStatus LinkLines(delta_SState* D, delta_TBool bExec) {
+	for (size_t i = 0; i < D->lineVector.size; ++i) {
+		const delta_SLine* node = D->lineVector.array[i];
+
+		const delta_EStatus status = delta_Link(D, D->bytecode, node->offset, node->offset + node->bytecodeSize);
+		if (status != DELTA_OK) {
+			D->lineNumber = node->line;
+			return status;
+		}
+	}
+
+	if (bExec == dtrue)
+		return delta_Link(D, D->execBytecode, 0, D->execLine->bytecodeSize);
+
+	return DELTA_OK;
+}
@@ -21,6 +21,8 @@ typedef struct delta_SBytecode {
 	size_t			index;
 	delta_TByte*	bytecode;
 	delta_TBool		bCanResize;
+	delta_TBool		bExec; // Exec line, constants go to the exec pools
+	size_t			lastConcat; // Offset of the last concatenation emitted by `CompileMath`, see `OPCODE_APPENDS`
 } delta_SBytecode;
 
 /**
@@ -28,6 +30,33 @@ typedef struct delta_SBytecode {
  */
 delta_EStatus		delta_Compile(delta_SState* D);
 
+/**
+ * Patch `OPCODE_JMP` and `OPCODE_GOSUB` operands of `bytecode` in [`begin`; `end`) with the `D->lineVector` index
+ * of the target line, the line number operand is kept. Compiles the program first if needed
+ */
+delta_EStatus		delta_Link(delta_SState* D, delta_TByte* bytecode, size_t begin, size_t end);
+
+/**
+ * Index of the line a jump to `number` lands on: the line itself or the one before it
+ *
+ * \return `dfalse` if `number` is before the first line or past the last one
+ */
+delta_TBool			delta_FindJumpTarget(const delta_SState* D, size_t number, size_t* index);
+
+/**
+ * Peephole pass over [`begin`; `BC->index`), rewrites frequent opcode sequences into
+ * superinstructions and moves `BC->index` back. `begin` must be the start of an instruction.
+ * Fails on an unknown or truncated instruction
+ */
+delta_EStatus		delta_Optimize(delta_SBytecode* BC, size_t begin);
+
+/**
+ * Double the size of `BC->bytecode`
+ *
+ * \return `dfalse` if `BC` can't be resized or on allocation failure
+ */
+delta_TBool			delta_ExpandBytecode(delta_SState* D, delta_SBytecode* BC);
+
 /**
  * delta_CompileLine
  */
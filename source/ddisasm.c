@@ -0,0 +1,350 @@
+/**
+ * \file	ddisasm.c
+ * \brief	Listing of the compiled program, see `delta_Disassemble`
+ * \date	17 oct 2026
+ * \author	Reklov
+ */
+#include "deltabasic.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+
+#include "dlimits.h"
+#include "dstate.h"
+#include "dstring.h"
+#include "dcompiler.h"
+#include "dopcodes.h"
+
+#define DELTA_DISASM_BUFFER_SIZE		256 // Text of an instruction, longer ones are cut
+#define DELTA_DISASM_STRING_SIZE		32 // Characters of a string constant shown
+
+#define DisasmAssert(exp) { if ((exp) == dfalse) { return DELTA_WRITE_ERROR; }}
+
+// ******************************************************************************** //
+
+/**
+ * delta_SListing
+ */
+typedef struct delta_SListing {
+	delta_TWriteFunction	writeFunc;
+
+	char					buffer[DELTA_DISASM_BUFFER_SIZE];
+	size_t					size;
+} delta_SListing;
+
+// ******************************************************************************** //
+
+/**
+ * printf to the end of `L->buffer`, cut if it's full
+ */
+static void			Append(delta_SListing* L, const char* format, ...);
+
+/**
+ * Write `L->buffer` and empty it
+ */
+static delta_TBool	Flush(delta_SListing* L);
+
+/**
+ * Append a string constant in quotes, cut after `DELTA_DISASM_STRING_SIZE` characters
+ */
+static void			AppendString(delta_SListing* L, const delta_UStringValue* value);
+
+/**
+ * Append the name of the numeric variable of `slot`
+ */
+static void			AppendNumericVariable(delta_SListing* L, const delta_SState* D, delta_TWord slot);
+
+/**
+ * Append the name of the string variable of `slot`
+ */
+static void			AppendStringVariable(delta_SListing* L, const delta_SState* D, delta_TWord slot);
+
+/**
+ * Append a `DELTA_REGISTER_*` operand: variable name, temp, or the constant value
+ */
+static void			AppendRegister(delta_SListing* L, const delta_SState* D, delta_TWord operand);
+
+/**
+ * Append the decoded operands of the instruction at `bytecode`
+ */
+static void			AppendOperands(delta_SListing* L, const delta_SState* D, const delta_SLine* line, const delta_TByte* bytecode);
+
+/**
+ * Write the text of `line`, then an instruction per line
+ */
+static delta_TBool	DisassembleLine(delta_SListing* L, const delta_SState* D, const delta_SLine* line);
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * delta_Disassemble
+ */
+delta_EStatus delta_Disassemble(delta_SState* D, delta_TWriteFunction writeFunc) {
+	if (D == NULL)
+		return DELTA_STATE_IS_NULL;
+
+	if (writeFunc == NULL)
+		return DELTA_FUNC_IS_NULL;
+
+	if (D->bCompiled == dfalse) {
+		const delta_EStatus status = delta_Compile(D);
+		if (status != DELTA_OK)
+			return status;
+	}
+
+	delta_SListing L;
+	L.writeFunc	= writeFunc;
+	L.size		= 0;
+
+	size_t bytecodeSize = 0;
+	for (const delta_SLine* line = D->head; line != NULL; line = line->next)
+		bytecodeSize += line->bytecodeSize;
+
+	Append(&L, "; %zu lines, %zu bytes of bytecode", D->lineVector.size, bytecodeSize);
+	if (D->verification.bVerified == dtrue)
+		Append(&L, ", stacks verified (numeric %zu, string %zu)\n", D->verification.numericDepth, D->verification.stringDepth);
+	else
+		Append(&L, ", stacks checked while running\n");
+
+	DisasmAssert(Flush(&L));
+
+	for (const delta_SLine* line = D->head; line != NULL; line = line->next)
+		DisasmAssert(DisassembleLine(&L, D, line));
+
+	return DELTA_OK;
+}
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * Append
+ */
+void Append(delta_SListing* L, const char* format, ...) {
+	const size_t left = DELTA_DISASM_BUFFER_SIZE - L->size;
+	if (left <= 1)
+		return;
+
+	va_list args;
+	va_start(args, format);
+	const int size = vsnprintf(L->buffer + L->size, left, format, args);
+	va_end(args);
+
+	if (size > 0)
+		L->size += DELTABASIC_MIN((size_t)size, left - 1);
+}
+
+/* ****************************************
+ * Flush
+ */
+delta_TBool Flush(delta_SListing* L) {
+	const size_t size = L->size;
+	L->size = 0;
+
+	if (size == 0)
+		return dtrue;
+
+	return (L->writeFunc(L->buffer, 1, size) == size);
+}
+
+/* ****************************************
+ * AppendString
+ */
+void AppendString(delta_SListing* L, const delta_UStringValue* value) {
+	const size_t size = DELTA_STRING_SIZE(value);
+	const int shown = (int)DELTABASIC_MIN(size, (size_t)DELTA_DISASM_STRING_SIZE);
+
+	Append(L, "\"%.*s\"%s", shown, DELTA_STRING_DATA(value), (size > (size_t)shown) ? "..." : "");
+}
+
+/* ****************************************
+ * AppendNumericVariable
+ */
+void AppendNumericVariable(delta_SListing* L, const delta_SState* D, delta_TWord slot) {
+	Append(L, "%s", D->numericSlots.variables[slot]->name);
+}
+
+/* ****************************************
+ * AppendStringVariable
+ */
+void AppendStringVariable(delta_SListing* L, const delta_SState* D, delta_TWord slot) {
+	Append(L, "%s$", D->stringSlots.variables[slot]->name);
+}
+
+/* ****************************************
+ * AppendRegister
+ */
+void AppendRegister(delta_SListing* L, const delta_SState* D, delta_TWord operand) {
+	const delta_TWord index = operand & DELTA_REGISTER_INDEX_MASK;
+
+	switch (operand >> DELTA_REGISTER_BANK_SHIFT) {
+		case DELTA_REGISTER_VARIABLES:		AppendNumericVariable(L, D, index); break;
+		case DELTA_REGISTER_TEMPS:			Append(L, "t%u", index); break;
+		case DELTA_REGISTER_CONSTANTS:		Append(L, "%g", (double)D->registerConstants.values[index]); break;
+		case DELTA_REGISTER_EXEC_CONSTANTS:	Append(L, "%g", (double)D->execConstants[index]); break;
+	}
+}
+
+/* ****************************************
+ * AppendOperands
+ */
+void AppendOperands(delta_SListing* L, const delta_SState* D, const delta_SLine* line, const delta_TByte* bytecode) {
+	const delta_TByte* operands = bytecode + 1;
+	const delta_TWord word = *((const delta_TWord*)operands);
+
+	switch (bytecode[0]) {
+		case OPCODE_PUSHS:
+			if ((word & DELTA_STRING_CONSTANT_EXEC) != 0)
+				AppendString(L, &(D->execStringConstants.strings[word & DELTA_STRING_CONSTANT_INDEX_MASK]));
+			else
+				AppendString(L, &(D->stringConstants.strings[word]));
+			break;
+
+		case OPCODE_PUSHN:
+			Append(L, "%g", (double)(*((const delta_TNumber*)operands)));
+			break;
+
+		case OPCODE_SETN:
+		case OPCODE_GETN:
+		case OPCODE_SETFOR:
+		case OPCODE_SETSTEPFOR:
+		case OPCODE_INPUTN:
+		case OPCODE_PRINTVN:
+		case OPCODE_PRINTVNT:
+			AppendNumericVariable(L, D, word);
+			break;
+
+		case OPCODE_SETS:
+		case OPCODE_GETS:
+		case OPCODE_INPUTS:
+		case OPCODE_PRINTVS:
+		case OPCODE_PRINTVST:
+			AppendStringVariable(L, D, word);
+			break;
+
+		case OPCODE_JMP:
+		case OPCODE_GOSUB: { // Line index, written by `delta_Link`
+			const delta_SLine* target = D->lineVector.array[*((const delta_TDWord*)(operands + 4))];
+			Append(L, "%zu (offset %zu)", target->line, target->offset);
+			break;
+		}
+
+		case OPCODE_ALLOCN:
+		case OPCODE_GETIN:
+		case OPCODE_SETIN: // Array name in the text of the line
+			Append(L, "%.*s", (int)(*((const delta_TWord*)(operands + 2))), line->str + word);
+			break;
+
+		case OPCODE_ALLOCS:
+		case OPCODE_GETIS:
+		case OPCODE_SETIS:
+			Append(L, "%.*s$", (int)(*((const delta_TWord*)(operands + 2))), line->str + word);
+			break;
+
+		case OPCODE_CALL:
+		case OPCODE_CALLR:
+			Append(L, "%s", D->cfuncVector.array[word]->name);
+			break;
+
+		case OPCODE_INCN:
+		case OPCODE_SETNC:
+			AppendNumericVariable(L, D, word);
+			Append(L, ", %g", (double)(*((const delta_TNumber*)(operands + 2))));
+			break;
+
+		case OPCODE_JNLNC:
+			AppendNumericVariable(L, D, word);
+			Append(L, " %s %g", delta_GetOpcodeName(operands[2]), (double)(*((const delta_TNumber*)(operands + 3))));
+			break;
+
+		case OPCODE_JNLNN:
+			AppendNumericVariable(L, D, word);
+			Append(L, " %s ", delta_GetOpcodeName(operands[2]));
+			AppendNumericVariable(L, D, *((const delta_TWord*)(operands + 3)));
+			break;
+
+		case OPCODE_RADD:
+		case OPCODE_RSUB:
+		case OPCODE_RMUL:
+		case OPCODE_RDIV:
+		case OPCODE_RMOD:
+		case OPCODE_RPOW:
+		case OPCODE_RET:
+		case OPCODE_RNET:
+		case OPCODE_RLT:
+		case OPCODE_RGT:
+		case OPCODE_RLET:
+		case OPCODE_RGET:
+			AppendRegister(L, D, word);
+			Append(L, ", ");
+			AppendRegister(L, D, *((const delta_TWord*)(operands + 2)));
+			Append(L, ", ");
+			AppendRegister(L, D, *((const delta_TWord*)(operands + 4)));
+			break;
+
+		case OPCODE_RMOV:
+		case OPCODE_RNEG:
+			AppendRegister(L, D, word);
+			Append(L, ", ");
+			AppendRegister(L, D, *((const delta_TWord*)(operands + 2)));
+			break;
+
+		case OPCODE_RPUSH:
+		case OPCODE_RJNLZ:
+			AppendRegister(L, D, word);
+			break;
+
+		case OPCODE_CONCATN:
+			Append(L, "%u", operands[0]);
+			break;
+
+		case OPCODE_APPENDS:
+			AppendStringVariable(L, D, word);
+			Append(L, ", %u", operands[2]);
+			break;
+
+		default:
+			break;
+	}
+}
+
+/* ****************************************
+ * DisassembleLine
+ */
+delta_TBool DisassembleLine(delta_SListing* L, const delta_SState* D, const delta_SLine* line) {
+	const size_t textSize = delta_Strlen(line->str);
+
+	Append(L, "%zu", line->line);
+	if ((Flush(L) == dfalse) || (L->writeFunc(line->str, sizeof(delta_TChar), textSize) != textSize))
+		return dfalse;
+
+	Append(L, "\n");
+
+	const size_t end = line->offset + line->bytecodeSize;
+	size_t ip = line->offset;
+	while (ip < end) {
+		const delta_TByte opcode = D->bytecode[ip];
+
+		// Segments are checked by `delta_VerifyProgram`
+		const size_t size = delta_GetOpcodeSize(opcode);
+		if ((size == 0) || (size > end - ip)) {
+			Append(L, "  %6zu  ?? %u\n", ip, opcode);
+			break;
+		}
+
+		if (size == 1) {
+			Append(L, "  %6zu  %s", ip, delta_GetOpcodeName(opcode));
+		}
+		else {
+			Append(L, "  %6zu  %-10s ", ip, delta_GetOpcodeName(opcode));
+			AppendOperands(L, D, line, D->bytecode + ip);
+		}
+		Append(L, "\n");
+
+		if (Flush(L) == dfalse)
+			return dfalse;
+
+		ip += size;
+	}
+
+	return Flush(L);
+}
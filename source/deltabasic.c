@@ -17,6 +17,10 @@
 #include "dmemory.h"
 #include "dcompiler.h"
 #include "dmachine.h"
+#include "dimage.h"
+#include "dopcodes.h"
+
+#define SAMPLE_INTERVAL			1000 // Microseconds of CPU time between the samples of `--sample`
 
 #define CreateStateAssert(exp)	if (exp) { delta_ReleaseState(D); return NULL; }
 
@@ -34,46 +38,203 @@ int delta_Input(delta_TChar* buffer, size_t size);
 
 // ******************************************************************************** //
 
-#ifndef __DELTABASIC_LIB__
+#if !defined(__DELTABASIC_LIB__) && !defined(__DELTABASIC_DBASC__)
+
+#include <signal.h>
+#include <sys/time.h>
 
 // ******************************************************************************** //
 
 /**
- * LoadFile
+ * Input of `ReadFile`
+ */
+static FILE* pLoadFile = NULL;
+
+/**
+ * Output of `WriteFile`
+ */
+static FILE* pSaveFile = NULL;
+
+/**
+ * ReadFile
+ */
+size_t ReadFile(void* pData, size_t size, size_t count);
+
+/**
+ * WriteFile
  */
-char* LoadFile(const char path[]);
+size_t WriteFile(const void* pData, size_t size, size_t count);
+
+/**
+ * File starting with `DELTA_IMAGE_MAGIC`, see `delta_SaveImage`
+ */
+delta_TBool IsImageFile(const char path[]);
+
+/**
+ * PrintMemoryStats
+ */
+void PrintMemoryStats(delta_SState* D);
+
+/**
+ * Lines, then opcodes, by decreasing cost: time, then instructions
+ */
+void PrintProfile(delta_SState* D);
+
+/**
+ * `qsort` comparison of `delta_SProfileEntry`, see `PrintProfile`
+ */
+int CompareProfileEntries(const void* a, const void* b);
+
+/**
+ * Print the entries of `kind` that ran, sorted
+ */
+void PrintProfileEntries(delta_SState* D, delta_EProfileKind kind);
+
+/**
+ * State of `SampleSignal`
+ */
+static delta_SState* pSampledState = NULL;
+
+/**
+ * `SIGPROF` handler
+ */
+void SampleSignal(int signal);
+
+/**
+ * Ask `D` for a sample every `SAMPLE_INTERVAL` of CPU time, see `--sample`
+ */
+void StartSampling(delta_SState* D);
+
+/**
+ * Stop the timer and write the samples of `D` to `path`, or to the standard output if `NULL`
+ */
+void StopSampling(delta_SState* D, const char path[]);
 
 /**
  * main
  */
 int main(int argc, char* argv[]) {
-	delta_SState* D = delta_CreateState(NULL, NULL);
+	const char* path = NULL;
+	const char* outPath = NULL; // `-c` writes the compiled program there instead of running it, `--sample` the samples
+	delta_TBool bCompileOnly = dfalse;
+	delta_TBool bDisassemble = dfalse; // `--disasm` lists the compiled program instead of running it
+	unsigned int flags = DELTA_STATE_DEFAULT;
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "-c") == 0)
+			bCompileOnly = dtrue;
+		else if ((strcmp(argv[i], "-o") == 0) && (i + 1 < argc))
+			outPath = argv[++i];
+		else if (strcmp(argv[i], "--register") == 0)
+			flags |= DELTA_STATE_REGISTER_VM;
+		else if (strcmp(argv[i], "--arena") == 0)
+			flags |= DELTA_STATE_ARENA;
+		else if (strcmp(argv[i], "--memstats") == 0)
+			flags |= DELTA_STATE_MEMORY_STATS;
+		else if (strcmp(argv[i], "--disasm") == 0)
+			bDisassemble = dtrue;
+		else if (strcmp(argv[i], "--profile") == 0)
+			flags |= DELTA_STATE_PROFILE | DELTA_STATE_PROFILE_TIME;
+		else if (strcmp(argv[i], "--sample") == 0)
+			flags |= DELTA_STATE_SAMPLE;
+		else
+			path = argv[i];
+	}
 
-	if (argc == 2) {
-		char* code = LoadFile(argv[1]);
-		if (code == NULL)
-			return -1;
+	if ((bCompileOnly == dtrue) && ((path == NULL) || (outPath == NULL))) {
+		printf("Usage: dbas -c prog.bas -o prog.dbc\n");
+		return -1;
+	}
 
-		if (delta_LoadString(D, code) != DELTA_OK) {
-			printf("can't load code. Abort\n");
+	if ((bDisassemble == dtrue) && (path == NULL)) {
+		printf("Usage: dbas --disasm prog.bas\n");
+		return -1;
+	}
+
+	delta_SState* D = delta_CreateStateEx(NULL, NULL, flags);
+
+	if (path != NULL) {
+		const delta_TBool bImage = IsImageFile(path);
+
+		pLoadFile = fopen(path, (bImage == dtrue) ? "rb" : "rt");
+		if (pLoadFile == NULL) {
+			printf("Can't open file: \"%s\"\n", path);
 			delta_ReleaseState(D);
-			free(code);
 
 			return -1;
 		}
-		
-		free(code);
 
-		printf("Compiling...\n");
-		if (delta_Compile(D) != DELTA_OK) {
-			printf("can't compile code (ERROR IN %zu). Abort\n", D->lineNumber);
+		const delta_EStatus loadStatus = (bImage == dtrue) ? delta_LoadImage(D, ReadFile) : delta_Load(D, ReadFile);
+		fclose(pLoadFile);
+
+		if (loadStatus != DELTA_OK) {
+			if ((bImage == dfalse) && (loadStatus == DELTA_SYNTAX_ERROR))
+				printf("can't load code (LINE %zu TOO LONG). Abort\n", D->lineNumber);
+			else
+				printf("can't load code. Abort\n");
 			delta_ReleaseState(D);
 
 			return -1;
 		}
 
+		if (bImage == dfalse) {
+			printf("Compiling...\n");
+			if (delta_Compile(D) != DELTA_OK) {
+				printf("can't compile code (ERROR IN %zu). Abort\n", D->lineNumber);
+				delta_ReleaseState(D);
+
+				return -1;
+			}
+		}
+
+		if (bCompileOnly == dtrue) {
+			pSaveFile = fopen(outPath, "wb");
+			if (pSaveFile == NULL) {
+				printf("Can't open file: \"%s\"\n", outPath);
+				delta_ReleaseState(D);
+
+				return -1;
+			}
+
+			const delta_EStatus saveStatus = delta_SaveImage(D, WriteFile);
+			fclose(pSaveFile);
+			delta_ReleaseState(D);
+
+			if (saveStatus != DELTA_OK) {
+				printf("can't save image. Abort\n");
+				return -1;
+			}
+
+			return 0;
+		}
+
+		if (bDisassemble == dtrue) {
+			pSaveFile = stdout;
+
+			const delta_EStatus disasmStatus = delta_Disassemble(D, WriteFile);
+			delta_ReleaseState(D);
+
+			if (disasmStatus != DELTA_OK) {
+				printf("can't disassemble code. Abort\n");
+				return -1;
+			}
+
+			return 0;
+		}
+
 		printf("Interpreting...\n");
+		if ((flags & DELTA_STATE_SAMPLE) != 0)
+			StartSampling(D);
+
 		delta_EStatus status = delta_Interpret(D, 0);
+		if ((flags & DELTA_STATE_SAMPLE) != 0)
+			StopSampling(D, outPath);
+
+		if ((flags & DELTA_STATE_MEMORY_STATS) != 0)
+			PrintMemoryStats(D);
+
+		if ((flags & DELTA_STATE_PROFILE) != 0)
+			PrintProfile(D);
+
 		if (status != DELTA_OK) {
 			delta_ReleaseState(D);
 			if (status == DELTA_END)
@@ -121,32 +282,176 @@ int main(int argc, char* argv[]) {
 // ******************************************************************************** //
 
 /* ****************************************
- * LoadFile
+ * ReadFile
  */
-char* LoadFile(const char path[]) {
-	FILE* pFile = fopen(path, "rt");
-	if (pFile == NULL) {
-		printf("Can't open file: \"%s\"\n", path);
-		return NULL;
+size_t ReadFile(void* pData, size_t size, size_t count) {
+	return fread(pData, size, count, pLoadFile);
+}
+
+/* ****************************************
+ * WriteFile
+ */
+size_t WriteFile(const void* pData, size_t size, size_t count) {
+	return fwrite(pData, size, count, pSaveFile);
+}
+
+/* ****************************************
+ * IsImageFile
+ */
+delta_TBool IsImageFile(const char path[]) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return dfalse;
+
+	char magic[sizeof(DELTA_IMAGE_MAGIC)] = { 0 };
+	const size_t size = fread(magic, 1, sizeof(magic), file);
+	fclose(file);
+
+	return ((size == sizeof(magic)) && (memcmp(magic, DELTA_IMAGE_MAGIC, sizeof(magic)) == 0));
+}
+
+/* ****************************************
+ * PrintMemoryStats
+ */
+void PrintMemoryStats(delta_SState* D) {
+	static const char* names[DELTA_MEMORY_TOTAL + 1] = {
+		"lines", "variables", "arrays", "strings", "bytecode", "cfunctions", "profile", "arena", "total"
+	};
+
+	printf("%-12s %10s %10s %8s %8s %8s\n", "category", "live", "peak", "allocs", "reallocs", "frees");
+	for (int i = 0; i <= DELTA_MEMORY_TOTAL; ++i) {
+		delta_SMemoryStats stats = { 0 };
+		delta_GetMemoryStats(D, (delta_EMemoryCategory)i, &stats);
+
+		printf("%-12s %10zu %10zu %8zu %8zu %8zu\n", names[i], stats.liveBytes, stats.peakBytes, stats.allocations, stats.reallocations, stats.frees);
 	}
+}
 
-	fseek(pFile, 0, SEEK_END);
-	size_t size = (size_t)ftell(pFile);
-	//fseek(file, 0L, SEEK_SET);
-	rewind(pFile);
+/* ****************************************
+ * PrintProfile
+ */
+void PrintProfile(delta_SState* D) {
+	PrintProfileEntries(D, DELTA_PROFILE_LINES);
+	printf("\n");
+	PrintProfileEntries(D, DELTA_PROFILE_OPCODES);
+}
 
-	char* buffer = (char*)malloc(sizeof(char) * (size + 2));
-	if (buffer == NULL) {
-		fclose(pFile);
-		return NULL;
+/* ****************************************
+ * CompareProfileEntries
+ */
+int CompareProfileEntries(const void* a, const void* b) {
+	const delta_SProfileCounts* first	= &(((const delta_SProfileEntry*)a)->counts);
+	const delta_SProfileCounts* second	= &(((const delta_SProfileEntry*)b)->counts);
+
+	if (first->nanoseconds != second->nanoseconds)
+		return (first->nanoseconds < second->nanoseconds) ? 1 : -1;
+
+	if (first->instructions != second->instructions)
+		return (first->instructions < second->instructions) ? 1 : -1;
+
+	return 0;
+}
+
+/* ****************************************
+ * PrintProfileEntries
+ */
+void PrintProfileEntries(delta_SState* D, delta_EProfileKind kind) {
+	size_t count = 0;
+	delta_SProfileEntry entry;
+	while (delta_GetProfile(D, kind, count, &entry) == DELTA_OK)
+		++count;
+
+	delta_SProfileEntry* entries = (delta_SProfileEntry*)malloc(sizeof(delta_SProfileEntry) * count);
+	if (entries == NULL)
+		return;
+
+	size_t instructions = 0;
+	unsigned long long nanoseconds = 0;
+	for (size_t i = 0; i < count; ++i) {
+		delta_GetProfile(D, kind, i, &(entries[i]));
+		instructions	+= entries[i].counts.instructions;
+		nanoseconds		+= entries[i].counts.nanoseconds;
 	}
-	
-	fread(buffer, sizeof(char), size, pFile);
-	fclose(pFile);
-	buffer[size] = '\n';
-	buffer[size + 1] = '\0';
 
-	return buffer;
+	qsort(entries, count, sizeof(delta_SProfileEntry), CompareProfileEntries);
+
+	if (kind == DELTA_PROFILE_LINES)
+		printf("%-10s %14s %7s %12s %7s  %s\n", "line", "instructions", "%", "time (us)", "%", "text");
+	else
+		printf("%-10s %14s %7s %12s %7s\n", "opcode", "instructions", "%", "time (us)", "%");
+	for (size_t i = 0; i < count; ++i) {
+		const delta_SProfileCounts* counts = &(entries[i].counts);
+		if (counts->instructions == 0)
+			break;
+
+		char key[32];
+		if (kind == DELTA_PROFILE_OPCODES)
+			snprintf(key, sizeof(key), "%s", entries[i].name);
+		else if (entries[i].key == DELTABASIC_EXEC_LINE_NUMBER)
+			snprintf(key, sizeof(key), "exec");
+		else
+			snprintf(key, sizeof(key), "%zu", entries[i].key);
+
+		printf("%-10s %14zu %6.2f%% %12.1f %6.2f%%", key,
+			counts->instructions, 100.0 * (double)counts->instructions / (double)instructions,
+			(double)counts->nanoseconds / 1000.0, (nanoseconds != 0) ? 100.0 * (double)counts->nanoseconds / (double)nanoseconds : 0.0);
+
+		if (kind == DELTA_PROFILE_LINES)
+			printf("  %s", entries[i].name);
+
+		printf("\n");
+	}
+
+	free(entries);
+}
+
+/* ****************************************
+ * SampleSignal
+ */
+void SampleSignal(int signal) {
+	(void)signal;
+	delta_RequestSample(pSampledState);
+}
+
+/* ****************************************
+ * StartSampling
+ */
+void StartSampling(delta_SState* D) {
+	pSampledState = D;
+
+	struct sigaction action;
+	memset(&action, 0x00, sizeof(struct sigaction));
+	action.sa_handler	= SampleSignal;
+	action.sa_flags		= SA_RESTART;
+	sigemptyset(&(action.sa_mask));
+	sigaction(SIGPROF, &action, NULL);
+
+	struct itimerval timer;
+	timer.it_interval.tv_sec	= 0;
+	timer.it_interval.tv_usec	= SAMPLE_INTERVAL;
+	timer.it_value				= timer.it_interval;
+	setitimer(ITIMER_PROF, &timer, NULL);
+}
+
+/* ****************************************
+ * StopSampling
+ */
+void StopSampling(delta_SState* D, const char path[]) {
+	struct itimerval timer;
+	memset(&timer, 0x00, sizeof(struct itimerval));
+	setitimer(ITIMER_PROF, &timer, NULL);
+
+	pSaveFile = (path != NULL) ? fopen(path, "wt") : stdout;
+	if (pSaveFile == NULL) {
+		printf("Can't open file: \"%s\"\n", path);
+		return;
+	}
+
+	if (delta_WriteSamples(D, WriteFile) != DELTA_OK)
+		printf("can't write samples\n");
+
+	if (pSaveFile != stdout)
+		fclose(pSaveFile);
 }
 
 // ******************************************************************************** //
@@ -187,6 +492,13 @@ int delta_Input(delta_TChar* buffer, size_t size) {
  * delta_CreateState
  */
 delta_SState* delta_CreateState(delta_TAllocFunction allocFunc, void* allocFuncUserData) {
+	return delta_CreateStateEx(allocFunc, allocFuncUserData, DELTA_STATE_DEFAULT);
+}
+
+/* ****************************************
+ * delta_CreateStateEx
+ */
+delta_SState* delta_CreateStateEx(delta_TAllocFunction allocFunc, void* allocFuncUserData, unsigned int flags) {
 	if (allocFunc == NULL)
 		allocFunc = delta_Allocator;
 
@@ -200,23 +512,104 @@ delta_SState* delta_CreateState(delta_TAllocFunction allocFunc, void* allocFuncU
 	D->allocFuncUserData		= allocFuncUserData;
 	D->printFunction			= delta_Print;
 	D->inputFunction			= delta_Input;
+	D->flags					= flags;
 
-	D->execLine					= (delta_SLine*)DELTA_Alloc(D, sizeof(delta_SLine) + sizeof(delta_TChar) * DELTABASIC_EXEC_STRING_SIZE);
+	D->execLine					= (delta_SLine*)DELTA_Alloc(D, DELTA_MEMORY_LINES, sizeof(delta_SLine) + sizeof(delta_TChar) * DELTABASIC_EXEC_STRING_SIZE);
 	CreateStateAssert(D->execLine == NULL);
+	memset(D->execLine, 0x00, sizeof(delta_SLine) + sizeof(delta_TChar) * DELTABASIC_EXEC_STRING_SIZE);
 	D->execLine->str			= (char*)(((delta_TByte*)D->execLine) + sizeof(delta_SLine));
 
-	D->bytecodeSize				= DELTABASIC_EXEC_BYTECODE_SIZE + DELTABASIC_COMPILER_INITIAL_BYTECODE_SIZE;
-	D->bytecode					= (delta_TByte*)DELTA_Alloc(D, sizeof(delta_TByte) * D->bytecodeSize);
+	D->bytecodeSize				= DELTABASIC_COMPILER_INITIAL_BYTECODE_SIZE;
+	D->bytecode					= (delta_TByte*)DELTA_Alloc(D, DELTA_MEMORY_BYTECODE, sizeof(delta_TByte) * D->bytecodeSize);
 	CreateStateAssert(D->bytecode == NULL);
 
 	D->cfuncVector.allocated 	= DELTABASIC_CFUNC_VECTOR_START_SIZE;
 	D->cfuncVector.size			= 0;
-	D->cfuncVector.array		= (delta_SCFunction**)DELTA_Alloc(D, sizeof(delta_SCFunction*) * D->cfuncVector.allocated);
+	D->cfuncVector.array		= (delta_SCFunction**)DELTA_Alloc(D, DELTA_MEMORY_CFUNCTIONS, sizeof(delta_SCFunction*) * D->cfuncVector.allocated);
 	CreateStateAssert(D->cfuncVector.array == NULL);
 
 	return D;
 }
 
+/* ****************************************
+ * FreeProgram
+ *
+ * Free lines, variables and arrays, leaving `D` without a program
+ */
+static void FreeProgram(delta_SState* D) {
+	if ((D->flags & DELTA_STATE_ARENA) == 0) { // Otherwise the nodes go with the arena
+		delta_SLine* line = D->head;
+		while (line != NULL) {
+			delta_SLine* next = line->next;
+
+			delta_FreeNode(D, line);
+
+			line = next; 
+		}
+	}
+
+	if ((D->flags & DELTA_STATE_ARENA) == 0) {
+		for (size_t i = 0; i < D->numericVariables.allocated; ++i) {
+			if (D->numericVariables.entries[i].name != NULL)
+				delta_FreeNumericVariable(D, (delta_SNumericVariable*)(D->numericVariables.entries[i].value));
+		}
+
+		for (size_t i = 0; i < D->stringVariables.allocated; ++i) {
+			if (D->stringVariables.entries[i].name != NULL)
+				delta_FreeStringVariable(D, (delta_SStringVariable*)(D->stringVariables.entries[i].value));
+		}
+	}
+
+	if (D->lineVector.allocated != 0) {
+		DELTA_Free(D, DELTA_MEMORY_LINES, D->lineVector.array, sizeof(delta_SLine*) * D->lineVector.allocated);
+	}
+
+	if (D->registerConstants.allocated != 0) {
+		DELTA_Free(D, DELTA_MEMORY_BYTECODE, D->registerConstants.values, sizeof(delta_TNumber) * D->registerConstants.allocated);
+	}
+
+	{
+		for (size_t i = 0; i < D->stringSlots.size; ++i)
+			delta_ReleaseStringValue(D, &(D->stringSlots.values[i]));
+
+		if (D->numericSlots.allocated != 0) {
+			DELTA_Free(D, DELTA_MEMORY_VARIABLES, D->numericSlots.values, sizeof(delta_TNumber) * D->numericSlots.allocated);
+			DELTA_Free(D, DELTA_MEMORY_VARIABLES, D->numericSlots.variables, sizeof(delta_SNumericVariable*) * D->numericSlots.allocated);
+		}
+
+		if (D->stringSlots.allocated != 0) {
+			DELTA_Free(D, DELTA_MEMORY_VARIABLES, D->stringSlots.values, sizeof(delta_UStringValue) * D->stringSlots.allocated);
+			DELTA_Free(D, DELTA_MEMORY_VARIABLES, D->stringSlots.variables, sizeof(delta_SStringVariable*) * D->stringSlots.allocated);
+		}
+	}
+
+	for (size_t i = 0; i < D->numericArrays.allocated; ++i) {
+		if (D->numericArrays.entries[i].name != NULL)
+			delta_FreeNumericArray(D, (delta_SNumericArray*)(D->numericArrays.entries[i].value));
+	}
+
+	for (size_t i = 0; i < D->stringArrays.allocated; ++i) {
+		if (D->stringArrays.entries[i].name != NULL)
+			delta_FreeStringArray(D, (delta_SStringArray*)(D->stringArrays.entries[i].value));
+	}
+
+	delta_ReleaseArena(D);
+
+	D->head	= NULL;
+	D->tail	= NULL;
+
+	delta_FreeNameTable(D, &(D->numericVariables), DELTA_MEMORY_VARIABLES);
+	delta_FreeNameTable(D, &(D->stringVariables), DELTA_MEMORY_VARIABLES);
+	delta_FreeNameTable(D, &(D->numericArrays), DELTA_MEMORY_ARRAYS);
+	delta_FreeNameTable(D, &(D->stringArrays), DELTA_MEMORY_ARRAYS);
+
+	memset(&(D->lineVector), 0x00, sizeof(delta_SLineVector));
+	memset(&(D->registerConstants), 0x00, sizeof(delta_SRegisterConstants));
+	memset(&(D->numericSlots), 0x00, sizeof(delta_SNumericSlots));
+	memset(&(D->stringSlots), 0x00, sizeof(delta_SStringSlots));
+}
+
+
 /* ****************************************
  * delta_ReleaseState
  */
@@ -227,73 +620,129 @@ void delta_ReleaseState(delta_SState* D) {
 	delta_TAllocFunction allocFunc	= D->allocFunction;
 	void* userData					= D->allocFuncUserData;
 
-	DELTA_Free(D, D->execLine, sizeof(delta_SLine) + sizeof(delta_TChar) * DELTABASIC_EXEC_STRING_SIZE);
-	DELTA_Free(D, D->bytecode, sizeof(delta_TByte) * D->bytecodeSize);
+	DELTA_Free(D, DELTA_MEMORY_LINES, D->execLine, sizeof(delta_SLine) + sizeof(delta_TChar) * DELTABASIC_EXEC_STRING_SIZE);
+	if (D->bAttached == dfalse)
+		DELTA_Free(D, DELTA_MEMORY_BYTECODE, D->bytecode, sizeof(delta_TByte) * D->bytecodeSize);
 
 	if (D->cfuncVector.array != NULL) {
 		for (size_t i = 0; i < D->cfuncVector.size; ++i)
 			delta_FreeCFunction(D, D->cfuncVector.array[i]);
 
-		DELTA_Free(D, D->cfuncVector.array, sizeof(delta_SCFunction*) * D->cfuncVector.allocated);
+		DELTA_Free(D, DELTA_MEMORY_CFUNCTIONS, D->cfuncVector.array, sizeof(delta_SCFunction*) * D->cfuncVector.allocated);
 	}
 
-	{
-		delta_SLine* line = D->head;
-		while (line != NULL) {
-			delta_SLine* next = line->next;
+	delta_FreeNameTable(D, &(D->cfuncVector.names), DELTA_MEMORY_CFUNCTIONS);
 
-			delta_FreeNode(D, line);
+	FreeProgram(D);
 
-			line = next; 
-		}
-	}
+	delta_FreeStringStack(D);
+	delta_ReleaseStringValue(D, &(D->cfuncReturnString));
 
-	{
-		delta_SNumericVariable* nvar = D->numericValiables;
-		while (nvar != NULL) {
-			delta_SNumericVariable* next = nvar->next;
+	delta_ClearStringConstants(D, &(D->stringConstants), dtrue);
+	delta_ClearStringConstants(D, &(D->execStringConstants), dtrue);
 
-			delta_FreeNumericVariable(D, nvar);
+	delta_FreeStringPool(D);
+	delta_FreeSamples(D);
 
-			nvar = next; 
-		}
-	}
-	
-	{
-		delta_SStringVariable* nvar = D->stringVariables;
-		while (nvar != NULL) {
-			delta_SStringVariable* next = nvar->next;
+	allocFunc(D, sizeof(delta_SState), 0, userData);
+}
 
-			delta_FreeStringVariable(D, nvar);
+/* ****************************************
+ * delta_GetMemoryStats
+ */
+delta_EStatus delta_GetMemoryStats(delta_SState* D, delta_EMemoryCategory category, delta_SMemoryStats* stats) {
+	if (D == NULL)
+		return DELTA_STATE_IS_NULL;
 
-			nvar = next; 
-		}
-	}
+	if ((category < 0) || (category > DELTA_MEMORY_TOTAL))
+		return DELTA_ARG_OUT_OF_RANGE;
 
+	*stats = D->memoryStats[category];
+	return DELTA_OK;
+}
 
-	{
-		delta_SNumericArray* narr = D->numericArrays;
-		while (narr != NULL) {
-			delta_SNumericArray* next = narr->next;
+/* ****************************************
+ * delta_GetProfile
+ */
+delta_EStatus delta_GetProfile(delta_SState* D, delta_EProfileKind kind, size_t index, delta_SProfileEntry* entry) {
+	if (D == NULL)
+		return DELTA_STATE_IS_NULL;
 
-			delta_FreeNumericArray(D, narr);
+	switch (kind) {
+		case DELTA_PROFILE_LINES: {
+			if (index > D->lineVector.size)
+				return DELTA_ARG_OUT_OF_RANGE;
 
-			narr = next; 
+			const delta_SLine* line = (index < D->lineVector.size) ? D->lineVector.array[index] : D->execLine;
+			entry->key		= (line == D->execLine) ? DELTABASIC_EXEC_LINE_NUMBER : line->line;
+			entry->name		= line->str;
+			entry->counts	= line->profile;
+			return DELTA_OK;
 		}
+
+		case DELTA_PROFILE_OPCODES:
+			if (index >= OPCODE_COUNT)
+				return DELTA_ARG_OUT_OF_RANGE;
+
+			entry->key		= index;
+			entry->name		= delta_GetOpcodeName((delta_TByte)index);
+			entry->counts	= D->opcodeProfile[index];
+			return DELTA_OK;
 	}
 
-	{
-		delta_SStringArray* narr = D->stringArrays;
-		while (narr != NULL) {
-			delta_SStringArray* next = narr->next;
+	return DELTA_ARG_OUT_OF_RANGE;
+}
 
-			delta_FreeStringArray(D, narr);
+/* ****************************************
+ * delta_ResetProfile
+ */
+delta_EStatus delta_ResetProfile(delta_SState* D) {
+	if (D == NULL)
+		return DELTA_STATE_IS_NULL;
 
-			narr = next; 
-		}
+	for (delta_SLine* line = D->head; line != NULL; line = line->next)
+		memset(&(line->profile), 0x00, sizeof(delta_SProfileCounts));
+
+	memset(&(D->execLine->profile), 0x00, sizeof(delta_SProfileCounts));
+	memset(D->opcodeProfile, 0x00, sizeof(D->opcodeProfile));
+
+	delta_FreeSamples(D);
+	return DELTA_OK;
+}
+
+/* ****************************************
+ * delta_RequestSample
+ */
+delta_EStatus delta_RequestSample(delta_SState* D) {
+	if (D == NULL)
+		return DELTA_STATE_IS_NULL;
+
+	D->bSampleRequested = 1;
+	return DELTA_OK;
+}
+
+/* ****************************************
+ * delta_WriteSamples
+ */
+delta_EStatus delta_WriteSamples(delta_SState* D, delta_TWriteFunction writeFunc) {
+	if (D == NULL)
+		return DELTA_STATE_IS_NULL;
+
+	if (writeFunc == NULL)
+		return DELTA_FUNC_IS_NULL;
+
+	for (size_t i = 0; i < D->samples.size; ++i) {
+		const delta_SSample* sample = D->samples.array[i];
+		const size_t size = delta_Strlen(sample->name);
+
+		char count[32];
+		const size_t countSize = (size_t)snprintf(count, sizeof(count), " %zu\n", sample->count);
+
+		if ((writeFunc(sample->name, sizeof(delta_TChar), size) != size) || (writeFunc(count, 1, countSize) != countSize))
+			return DELTA_WRITE_ERROR;
 	}
-	
-	allocFunc(D, sizeof(delta_SState), 0, userData);
+
+	return DELTA_OK;
 }
 
 // ******************************************************************************** //
@@ -306,7 +755,7 @@ delta_EStatus delta_Run(delta_SState* D) {
 		return DELTA_STATE_IS_NULL;
 
 	if (D->bCompiled == dtrue) {
-		D->ip			= DELTABASIC_EXEC_BYTECODE_SIZE;
+		D->ip			= (D->head != NULL) ? D->head->offset : 0;
 		D->currentLine	= D->head;
 
 		return DELTA_OK;
@@ -315,6 +764,42 @@ delta_EStatus delta_Run(delta_SState* D) {
 	return delta_Compile(D);
 }
 
+/* ****************************************
+ * delta_New
+ */
+delta_EStatus delta_New(delta_SState* D) {
+	if (D == NULL)
+		return DELTA_STATE_IS_NULL;
+
+	if (D->bAttached == dtrue) {
+		if (delta_DetachImage(D) == dfalse)
+			return DELTA_ALLOCATOR_ERROR;
+	}
+
+	FreeProgram(D);
+
+	delta_FreeStringStack(D);
+	delta_ReleaseStringValue(D, &(D->cfuncReturnString));
+
+	delta_ClearStringConstants(D, &(D->stringConstants), dfalse);
+	delta_ClearStringConstants(D, &(D->execStringConstants), dfalse);
+
+	D->ip			= 0;
+	D->currentLine	= NULL;
+	D->numericHead	= 0;
+	D->returnHead	= 0;
+	D->forHead		= 0;
+	D->bCompiled	= dfalse;
+
+	D->bytecodeEnd		= 0;
+	D->bytecodeGarbage	= 0;
+	D->constantsGarbage	= 0;
+
+	memset(&(D->verification), 0x00, sizeof(delta_SVerification));
+
+	return DELTA_OK;
+}
+
 /* ****************************************
  * delta_GetLastLine
  */
@@ -346,7 +831,7 @@ delta_EStatus delta_SetNumeric(delta_SState * D, const char name[], delta_TNumbe
 		return DELTA_ALLOCATOR_ERROR;
 
 
-	var->value = value;
+	D->numericSlots.values[var->slot] = value;
 
 	return DELTA_OK;
 }
@@ -367,7 +852,7 @@ delta_EStatus delta_GetNumeric(delta_SState* D, const char name[], delta_TNumber
 		return DELTA_ALLOCATOR_ERROR;
 
 	if (value != NULL)
-		*value = var->value;
+		*value = D->numericSlots.values[var->slot];
 
 	return DELTA_OK;
 }
@@ -382,26 +867,20 @@ delta_EStatus delta_SetString(delta_SState* D, const char name[], const char val
 	if (name == NULL)
 		return DELTA_STRING_IS_NULL;
 
-	size_t valueSize = strlen(value);
-	delta_TChar* buffer = (delta_TChar*)DELTA_Alloc(D, sizeof(delta_TChar) * (valueSize + 1));
-	if (name == NULL)
+	delta_UStringValue string;
+	if (delta_CreateStringValue(D, &string, value, strlen(value)) == dfalse)
 		return DELTA_ALLOCATOR_ERROR;
 
-	memcpy(buffer, value, sizeof(delta_TChar) * valueSize);
-	buffer[valueSize] = '\0';
-
 	size_t size = strlen(name);
 	delta_SStringVariable* var = delta_FindOrAddStringVariable(D, name, size);
 	if (var == NULL) {
-		DELTA_Free(D, buffer, sizeof(delta_TChar) * (valueSize + 1));
+		delta_ReleaseStringValue(D, &string);
 		return DELTA_ALLOCATOR_ERROR;
 	}
 
-	if (var->str != NULL) {
-		DELTA_Free(D, var->str, (strlen(var->str) + 1) * sizeof(delta_TChar));
-	}
-
-	var->str = buffer;
+	delta_UStringValue* str = &(D->stringSlots.values[var->slot]);
+	delta_ReleaseStringValue(D, str);
+	*str = string;
 
 	return DELTA_OK;
 }
@@ -422,7 +901,7 @@ delta_EStatus delta_GetString(delta_SState* D, const char name[], const char* va
 		return DELTA_ALLOCATOR_ERROR;
 
 	if (value != NULL)
-		*value = var->str;
+		*value = DELTA_STRING_DATA(&(D->stringSlots.values[var->slot]));
 
 	return DELTA_OK;
 }
@@ -505,19 +984,9 @@ delta_EStatus delta_ReturnString(delta_SState* D, const char value[]) {
 		return DELTA_CFUNC_WRONG_RETURN_TYPE;
 
 	if (D->bIgnoreCFuncReturn == dfalse) {
-		if (D->cfuncReturn.string != NULL) {
-			DELTA_Free(D, (delta_TChar*)(D->cfuncReturn.string), sizeof(delta_TChar) * (delta_Strlen(D->cfuncReturn.string) + 1));
-			D->cfuncReturn.string = NULL;
-		}
-
-		size_t size = delta_Strlen(value);
-		delta_TChar* string = DELTA_Alloc(D, sizeof(delta_TChar) * (size + 1));
-		if (string == NULL)
+		delta_ReleaseStringValue(D, &(D->cfuncReturnString));
+		if (delta_CreateStringValue(D, &(D->cfuncReturnString), value, delta_Strlen(value)) == dfalse)
 			return DELTA_ALLOCATOR_ERROR;
-
-		memcpy(string, value, sizeof(delta_TChar) * size);
-		string[size] = '\0';
-		D->cfuncReturn.string = string;
 	}
 
 	return DELTA_OK;
@@ -547,7 +1016,7 @@ delta_EStatus delta_RegisterCFunction(delta_SState* D, const char name[], delta_
 		return DELTA_CFUNC_NAME_EXISTS;
 
 	const size_t blockSize = sizeof(delta_SCFunction) + sizeof(delta_TChar) * (size + 1);
-	delta_SCFunction* funcData = (delta_SCFunction*)DELTA_Alloc(D, blockSize);
+	delta_SCFunction* funcData = (delta_SCFunction*)DELTA_Alloc(D, DELTA_MEMORY_CFUNCTIONS, blockSize);
 	if (funcData == NULL)
 		return DELTA_ALLOCATOR_ERROR;
 
@@ -563,27 +1032,11 @@ delta_EStatus delta_RegisterCFunction(delta_SState* D, const char name[], delta_
 			funcData->argsMask |= 1 << i;
 	}
 
-	if (D->cfuncVector.size + 1 >= D->cfuncVector.allocated) {
-		const size_t newSize = D->cfuncVector.allocated * 2;
-
-		D->cfuncVector.array = DELTA_Realloc(
-			D,
-			D->cfuncVector.array,
-			sizeof(delta_SCFunction*) * D->cfuncVector.allocated,
-			sizeof(delta_SCFunction*) * newSize
-		);
-
-		if (D->cfuncVector.array == NULL) {
-			delta_FreeCFunction(D, funcData);
-			return DELTA_ALLOCATOR_ERROR;
-		}
-
-		D->cfuncVector.allocated = newSize;
+	if (delta_AddCFunction(D, funcData) == dfalse) {
+		delta_FreeCFunction(D, funcData);
+		return DELTA_ALLOCATOR_ERROR;
 	}
 
-	D->cfuncVector.array[D->cfuncVector.size] = funcData;
-	++(D->cfuncVector.size);
-
 	return DELTA_OK;
 }
 
@@ -614,11 +1067,12 @@ delta_EStatus delta_Execute(delta_SState* D, const char execStr[]) {
 	delta_TInteger lineNumber = 0;
 	const char* str = delta_ReadInteger(execStr, &lineNumber);
 	if (str == NULL) {
-		delta_SBytecode bc;
+		delta_SBytecode bc = { 0 };
 		bc.bytecodeSize	= DELTABASIC_EXEC_BYTECODE_SIZE;
 		bc.index		= 0;
-		bc.bytecode		= D->bytecode;
+		bc.bytecode		= D->execBytecode;
 		bc.bCanResize	= dfalse;
+		bc.bExec		= dtrue;
 
 		memset(bc.bytecode, 0x00, DELTABASIC_EXEC_BYTECODE_SIZE);
 
@@ -629,10 +1083,18 @@ delta_EStatus delta_Execute(delta_SState* D, const char execStr[]) {
 		D->execLine->prev = NULL;
 		D->execLine->line = SIZE_MAX;
 
+		D->execLine->bytecodeSize = 0; // Not linked again by `delta_Compile` until it's compiled
+
 		delta_EStatus status = delta_CompileLine(D, D->execLine, NULL, &bc);
 		if (status != DELTA_OK)
 			return status;
 
+		D->execLine->bytecodeSize = bc.index;
+
+		status = delta_Link(D, D->execBytecode, 0, bc.index);
+		if (status != DELTA_OK)
+			return status;
+
 		D->currentLine = D->execLine;
 		D->ip = 0;
 
@@ -644,7 +1106,6 @@ delta_EStatus delta_Execute(delta_SState* D, const char execStr[]) {
 
 		size = (end - str) + 1;
 
-		D->bCompiled = dfalse;
 		if (size == 0)
 			delta_RemoveLine(D, lineNumber);
 		else {
@@ -672,17 +1133,37 @@ delta_EStatus delta_Interpret(delta_SState* D, size_t nInstructions) {
 	if (nInstructions == 0)
 		nInstructions = SIZE_MAX;
 	
-	for (size_t i = 0; i < nInstructions; ++i) {
-		delta_EStatus status = delta_ExecuteInstruction(D);
-		if (status != DELTA_OK)
-			return status;
+	return delta_ExecuteInstructions(D, nInstructions);
+}
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * LoadLine
+ *
+ * Insert the numbered line [`start`; `end`), `end` is its newline
+ */
+static delta_EStatus LoadLine(delta_SState* D, const delta_TChar* start, const delta_TChar* end) {
+	while (*start == ' ')
+		++start;
+
+	while ((*end == ' ') && (start < end))
+		--end;
+
+	delta_TInteger lineNumber = 0;
+	start = delta_ReadInteger(start, &lineNumber);
+	if (start != NULL) { // TODO: if (start == NULL)
+		const size_t size = end - start;
+
+		if (size != 0) {
+			if (delta_InsertLine(D, lineNumber, start, size) == dfalse)
+				return DELTA_ALLOCATOR_ERROR;
+		}
 	}
 
 	return DELTA_OK;
 }
 
-// ******************************************************************************** //
-
 /* ****************************************
  * delta_SetPrintFunction
  */
@@ -696,23 +1177,9 @@ delta_EStatus delta_LoadString(delta_SState* D, const delta_TChar str[]) {
 	const delta_TChar* start = str;
 	while (*str != '\0') {
 		if (*str == '\n') {
-			while (*start == ' ')
-				++start;
-
-			const delta_TChar* end = str;
-			while ((*end == ' ') && (start < end))
-				--end;
-
-			delta_TInteger lineNumber = 0;
-			start = delta_ReadInteger(start, &lineNumber);
-			if (start != NULL) { // TODO: if (start == NULL)
-				const size_t size = end - start;
-
-				if (size != 0) {
-					if (delta_InsertLine(D, lineNumber, start, size) == dfalse)
-						return DELTA_ALLOCATOR_ERROR;
-				}
-			}
+			delta_EStatus status = LoadLine(D, start, str);
+			if (status != DELTA_OK)
+				return status;
 
 			start = str + 1;
 		}
@@ -723,6 +1190,95 @@ delta_EStatus delta_LoadString(delta_SState* D, const delta_TChar str[]) {
 	return DELTA_OK;
 }
 
+/* ****************************************
+ * ExpandLoadBuffer
+ *
+ * Double the buffer of `delta_Load` full with the start of a line, `DELTA_SYNTAX_ERROR` with
+ * the number of that line in `D->lineNumber` if it's longer than `DELTABASIC_MAX_LINE_SIZE`
+ */
+static delta_EStatus ExpandLoadBuffer(delta_SState* D, delta_TChar** buffer, size_t* capacity) {
+	if (*capacity > DELTABASIC_MAX_LINE_SIZE) { // With its newline
+		const delta_TChar* str = *buffer;
+		while (*str == ' ')
+			++str;
+
+		(*buffer)[*capacity] = '\0';
+
+		delta_TInteger lineNumber = 0;
+		D->lineNumber = (delta_ReadInteger(str, &lineNumber) != NULL) ? (size_t)lineNumber : 0;
+
+		return DELTA_SYNTAX_ERROR;
+	}
+
+	const size_t newCapacity = DELTABASIC_MIN(*capacity * 2, DELTABASIC_MAX_LINE_SIZE + 1);
+
+	delta_TChar* newBuffer = (delta_TChar*)DELTA_Alloc(D, DELTA_MEMORY_LINES, sizeof(delta_TChar) * (newCapacity + 1)); // Not realloc, a failure keeps the buffer
+	if (newBuffer == NULL)
+		return DELTA_ALLOCATOR_ERROR;
+
+	memcpy(newBuffer, *buffer, sizeof(delta_TChar) * (*capacity));
+	DELTA_Free(D, DELTA_MEMORY_LINES, *buffer, sizeof(delta_TChar) * (*capacity + 1));
+
+	*buffer		= newBuffer;
+	*capacity	= newCapacity;
+
+	return DELTA_OK;
+}
+
+/* ****************************************
+ * delta_Load
+ */
+delta_EStatus delta_Load(delta_SState* D, delta_TReadFunction readFunc) {
+	if (D == NULL)
+		return DELTA_STATE_IS_NULL;
+
+	if (readFunc == NULL)
+		return DELTA_FUNC_IS_NULL;
+
+	size_t capacity = DELTABASIC_LOAD_BUFFER_SIZE; // Doubled while a line doesn't fit, see `DELTABASIC_MAX_LINE_SIZE`
+	delta_TChar* buffer = (delta_TChar*)DELTA_Alloc(D, DELTA_MEMORY_LINES, sizeof(delta_TChar) * (capacity + 1)); // Room for the newline of an unterminated last line
+	if (buffer == NULL)
+		return DELTA_ALLOCATOR_ERROR;
+
+	size_t size		= 0;
+	size_t scanned	= 0; // Characters of `buffer` known not to end a line
+
+	delta_EStatus status = DELTA_OK;
+	delta_TBool bEnd = dfalse;
+	while ((bEnd == dfalse) && (status == DELTA_OK)) {
+		const size_t count = readFunc(buffer + size, sizeof(delta_TChar), capacity - size);
+		if (count == 0) {
+			bEnd = dtrue;
+			if (size == 0)
+				break;
+
+			buffer[size++] = '\n';
+		}
+		else
+			size += count;
+
+		size_t start = 0;
+		for (size_t i = scanned; (i < size) && (status == DELTA_OK); ++i) {
+			if (buffer[i] == '\n') {
+				status = LoadLine(D, buffer + start, buffer + i);
+				start = i + 1;
+			}
+		}
+
+		if ((status == DELTA_OK) && (start == 0) && (size == capacity)) // The line doesn't fit
+			status = ExpandLoadBuffer(D, &buffer, &capacity);
+
+		// The line split across reads moves to the front
+		size -= start;
+		memmove(buffer, buffer + start, sizeof(delta_TChar) * size);
+		scanned = size;
+	}
+
+	DELTA_Free(D, DELTA_MEMORY_LINES, buffer, sizeof(delta_TChar) * (capacity + 1));
+
+	return status;
+}
+
 // ******************************************************************************** //
 
 /* ****************************************
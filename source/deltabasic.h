@@ -53,6 +53,10 @@ typedef enum {
 	DELTA_CFUNC_WRONG_ARG_TYPE,
 	DELTA_CFUNC_NAME_EXISTS,
 	DELTA_FUNC_CALLED_OUTSIDE_CFUNC,
+
+	DELTA_IMAGE_INVALID,
+	DELTA_IMAGE_INCOMPATIBLE, // Other version, number or character type, or byte order
+	DELTA_WRITE_ERROR,
 	
 	DELTA_MATH_STATUS,
 } delta_EStatus;
@@ -75,6 +79,19 @@ typedef struct delta_SState delta_SState;
  */
 typedef void* (*delta_TAllocFunction)(void* ptr, size_t currentSize, size_t newSize, void* userData);
 
+/**
+ * State flags, see `delta_CreateStateEx`
+ */
+typedef enum {
+	DELTA_STATE_DEFAULT			= 0,
+	DELTA_STATE_REGISTER_VM		= 1 << 0, // Compile numeric expressions to register instructions
+	DELTA_STATE_ARENA			= 1 << 1, // Allocate lines and variables in chunks, freed at once by `delta_New` and `delta_ReleaseState`
+	DELTA_STATE_MEMORY_STATS	= 1 << 2, // Count allocations, see `delta_GetMemoryStats`
+	DELTA_STATE_PROFILE			= 1 << 3, // Count instructions per line and per opcode, see `delta_GetProfile`
+	DELTA_STATE_PROFILE_TIME	= 1 << 4, // With `DELTA_STATE_PROFILE`, also time them. Reads the clock at every instruction
+	DELTA_STATE_SAMPLE			= 1 << 5, // Take the samples asked by `delta_RequestSample`, see `delta_WriteSamples`
+} delta_EStateFlags;
+
 /**
  * Create new DeltaBASIC state.
  * 
@@ -82,11 +99,95 @@ typedef void* (*delta_TAllocFunction)(void* ptr, size_t currentSize, size_t newS
  */
 delta_SState*		delta_CreateState(delta_TAllocFunction allocFunc, void* allocFuncUserData);
 
+/**
+ * Same as `delta_CreateState` with `flags` from `delta_EStateFlags`
+ */
+delta_SState*		delta_CreateStateEx(delta_TAllocFunction allocFunc, void* allocFuncUserData, unsigned int flags);
+
 /**
  * delta_ReleaseState
  */
 void				delta_ReleaseState(delta_SState* D);
 
+/**
+ * What an allocation is for, see `delta_GetMemoryStats`
+ */
+typedef enum {
+	DELTA_MEMORY_LINES,
+	DELTA_MEMORY_VARIABLES, // With their slots
+	DELTA_MEMORY_ARRAYS,
+	DELTA_MEMORY_STRINGS, // Heap strings and string constants
+	DELTA_MEMORY_BYTECODE, // With constants and compiler buffers
+	DELTA_MEMORY_CFUNCTIONS,
+	DELTA_MEMORY_PROFILE, // Samples of `DELTA_STATE_SAMPLE`
+	DELTA_MEMORY_ARENA, // Chunks of `DELTA_STATE_ARENA`, holding lines, variables and arrays instead
+	DELTA_MEMORY_TOTAL,
+} delta_EMemoryCategory;
+
+/**
+ * Allocator usage of a state, see `delta_GetMemoryStats`
+ */
+typedef struct delta_SMemoryStats {
+	size_t	liveBytes;
+	size_t	peakBytes;
+	size_t	allocations;
+	size_t	reallocations;
+	size_t	frees;
+	size_t	sizeClasses[DELTABASIC_MEMORY_SIZE_CLASSES]; // Allocations and reallocations of up to `16 << i` bytes, the last one counts the larger
+} delta_SMemoryStats;
+
+/**
+ * Get the allocator usage of `category`. The state structure itself isn't counted
+ *
+ * \note All zero unless `D` was created with `DELTA_STATE_MEMORY_STATS`
+ */
+delta_EStatus		delta_GetMemoryStats(delta_SState* D, delta_EMemoryCategory category, delta_SMemoryStats* stats);
+
+/**
+ * What `delta_GetProfile` enumerates
+ */
+typedef enum {
+	DELTA_PROFILE_LINES, // Program lines in order, then the exec line
+	DELTA_PROFILE_OPCODES, // By opcode value
+} delta_EProfileKind;
+
+/**
+ * Profiler counts of a line or an opcode
+ */
+typedef struct delta_SProfileCounts {
+	size_t				instructions;
+	unsigned long long	nanoseconds; // With `DELTA_STATE_PROFILE_TIME`, the C functions, `PRINT` and `INPUT` they run included
+} delta_SProfileCounts;
+
+/**
+ * delta_SProfileEntry
+ */
+typedef struct delta_SProfileEntry {
+	size_t					key; // Line number, `DELTABASIC_EXEC_LINE_NUMBER` for the exec line, or opcode
+	const char*				name; // Text of the line or name of the opcode, valid until the program changes
+	delta_SProfileCounts	counts;
+} delta_SProfileEntry;
+
+/**
+ * Get entry `index` of the profile of `kind`. Counts of a line start again when it's edited
+ *
+ * \return `DELTA_ARG_OUT_OF_RANGE` past the last entry
+ * \note All zero unless `D` was created with `DELTA_STATE_PROFILE`
+ */
+delta_EStatus		delta_GetProfile(delta_SState* D, delta_EProfileKind kind, size_t index, delta_SProfileEntry* entry);
+
+/**
+ * Zero the profiler counts of every line and opcode, and drop the samples
+ */
+delta_EStatus		delta_ResetProfile(delta_SState* D);
+
+/**
+ * Ask for a sample of the running line and of the lines of its pending `GOSUB`s, taken when the VM
+ * next leaves a line. Only sets a flag: async-signal-safe, meant for a `SIGPROF` handler.
+ * Ignored unless `D` was created with `DELTA_STATE_SAMPLE`, see `delta_WriteSamples`
+ */
+delta_EStatus		delta_RequestSample(delta_SState* D);
+
 // ******************************************************************************** //
 // C-side variables and commands
 //
@@ -106,7 +207,7 @@ delta_EStatus		delta_GotoLine(delta_SState* D, size_t line); // TODO: implement
  *
  * Delete all lines, variables and clear bytecode buffer
  */
-delta_EStatus		delta_New(delta_SState* D); // TODO: implement
+delta_EStatus		delta_New(delta_SState* D);
 
 /**
  * \param[out] line last line number
@@ -198,6 +299,11 @@ delta_EStatus		delta_Execute(delta_SState* D, const char str[]);
 /**
  * Interpret `nInstructions` VM's instructions
  * If `nInstructions` set to zero, interpret all code
+ *
+ * A superinstruction counts as the instructions it replaces, see `DELTABASIC_COMPILER_PEEPHOLE`
+ * and `OPCODE_CONCATN`, so the call can run up to `DELTABASIC_COMPILER_MAX_MATH_OPS`
+ * instructions past `nInstructions`
+ * With `DELTA_STATE_REGISTER_VM` each register instruction counts as one
  */
 delta_EStatus		delta_Interpret(delta_SState* D, size_t nInstructions);
 
@@ -206,20 +312,111 @@ delta_EStatus		delta_Interpret(delta_SState* D, size_t nInstructions);
 //
 
 /**
- * delta_TReadFunction
+ * Like `fread` on a stream known to the caller. Fills `pData` with up to `count` items
+ * of `size` bytes and returns how many were read, zero at the end of the input
  */
 typedef size_t (*delta_TReadFunction)(void* pData, size_t size, size_t count);
 
 /**
- * delta_Load
+ * Load numbered lines from `readFunc` as they arrive, through a buffer of `DELTABASIC_LOAD_BUFFER_SIZE`
+ * grown for longer lines. A line longer than `DELTABASIC_MAX_LINE_SIZE` is a `DELTA_SYNTAX_ERROR`,
+ * see `delta_GetLastLine`
  */
-delta_EStatus		delta_Load(delta_SState* D, delta_TReadFunction readFunc); // TODO: implement
+delta_EStatus		delta_Load(delta_SState* D, delta_TReadFunction readFunc);
 
 /**
  * delta_LoadString
  */
 delta_EStatus		delta_LoadString(delta_SState* D, const delta_TChar str[]);
 
+/**
+ * Like `fwrite` on a stream known to the caller. Returns how many of the `count` items
+ * of `size` bytes were written
+ */
+typedef size_t (*delta_TWriteFunction)(const void* pData, size_t size, size_t count);
+
+/**
+ * Write the compiled program as an image: bytecode, lines, constants and variable names.
+ * Compiles the program first if needed
+ */
+delta_EStatus		delta_SaveImage(delta_SState* D, delta_TWriteFunction writeFunc);
+
+/**
+ * Replace the program and variables with an image written by `delta_SaveImage`, ready to run
+ * as after `delta_Compile`. C functions called by the program must be registered first, with the same signatures
+ */
+delta_EStatus		delta_LoadImage(delta_SState* D, delta_TReadFunction readFunc);
+
+/**
+ * delta_SStaticImageLine
+ */
+typedef struct delta_SStaticImageLine {
+	size_t					number;
+	size_t					offset; // Of its segment in `bytecode`
+	size_t					bytecodeSize;
+	const delta_TChar*		text;
+} delta_SStaticImageLine;
+
+/**
+ * delta_SStaticImageCFunction
+ */
+typedef struct delta_SStaticImageCFunction {
+	const char*				name;
+	size_t					argCount;
+	unsigned char			argsMask; // Bit `i` set when argument `i` is a `DELTA_CFUNC_ARG_STRING`
+	delta_ECFuncArgType		retType;
+} delta_SStaticImageCFunction;
+
+/**
+ * delta_SStaticImage
+ *
+ * Compiled program as constant data, written as C by `dbasc`
+ */
+typedef struct delta_SStaticImage {
+	unsigned int						version; // `DELTA_IMAGE_VERSION` of `dbasc`
+
+	const unsigned char*				bytecode; // Linked, `OPCODE_CALL` operands are indices in `cfunctions`
+	size_t								bytecodeSize;
+
+	const delta_SStaticImageLine*		lines; // In order
+	size_t								lineCount;
+
+	const delta_TNumber*				registerConstants;
+	size_t								registerConstantCount;
+
+	const delta_TChar* const*			stringConstants;
+	size_t								stringConstantCount;
+
+	const delta_TChar* const*			numericVariables; // In slot order
+	size_t								numericVariableCount;
+
+	const delta_TChar* const*			stringVariables; // In slot order
+	size_t								stringVariableCount;
+
+	const delta_SStaticImageCFunction*	cfunctions;
+	size_t								cfunctionCount;
+} delta_SStaticImage;
+
+/**
+ * Replace the program and variables with `image`, ready to run as after `delta_Compile`.
+ * The bytecode and register constants are used in place and must outlive the program,
+ * the first edit compiles it again into a buffer of the state.
+ * C functions called by the program must be registered first, in the same order and with the same signatures
+ */
+delta_EStatus		delta_AttachImage(delta_SState* D, const delta_SStaticImage* image);
+
+/**
+ * Write a listing of the compiled program as text: every line followed by the offset, opcode
+ * and decoded operands of its instructions. Compiles the program first if needed
+ */
+delta_EStatus		delta_Disassemble(delta_SState* D, delta_TWriteFunction writeFunc);
+
+/**
+ * Write the samples in folded stack format, one `caller;...;line count` per line,
+ * ready for flame graph tools, see `delta_RequestSample`. The exec line is named `exec`
+ */
+delta_EStatus		delta_WriteSamples(delta_SState* D, delta_TWriteFunction writeFunc);
+
 // ******************************************************************************** //
 // Terminal IO
 //
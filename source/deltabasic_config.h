@@ -12,6 +12,12 @@
 
 #define DELTABASIC_COMPILER_INITIAL_BYTECODE_SIZE			64
 #define DELTABASIC_COMPILER_MAX_MATH_OPS					32
+#define DELTABASIC_COMPILER_PEEPHOLE						1 // Fuse frequent opcode sequences into superinstructions
+
+#define DELTABASIC_MACHINE_COMPUTED_GOTO					1 // Direct threaded dispatch where the compiler supports it
+#define DELTABASIC_MACHINE_REGISTER_TEMPS					8 // Temporaries of the register tier, see `DELTA_STATE_REGISTER_VM`
+#define DELTABASIC_MACHINE_PROFILER							1 // Counting of instructions for `DELTA_STATE_PROFILE`
+#define DELTABASIC_MACHINE_SAMPLER							1 // Samples of `DELTA_STATE_SAMPLE` at line boundaries
 
 #define DELTABASIC_EXEC_STRING_SIZE							128
 #define DELTABASIC_EXEC_BYTECODE_SIZE						128
@@ -24,12 +30,27 @@
 
 #define DELTABASIC_ARRAY_MIN_SIZE							11 // 0 to 10
 
+#define DELTABASIC_LINE_VECTOR_START_SIZE					64
+
+#define DELTABASIC_VARIABLE_SLOTS_START_SIZE				16
+#define DELTABASIC_NAME_TABLE_START_SIZE					32 // Power of two, see `delta_SNameTable`
+
+#define DELTABASIC_REGISTER_CONSTANTS_START_SIZE			32
+#define DELTABASIC_STRING_CONSTANTS_START_SIZE				16
+#define DELTABASIC_STRING_POOL_CLASSES						4 // Free lists of heap strings, 32 to 256 characters, see `delta_SStringPool`
+
 #define DELTABASIC_CFUNC_VECTOR_START_SIZE					16
+#define DELTABASIC_SAMPLE_VECTOR_START_SIZE					16
+
+#define DELTABASIC_ARENA_CHUNK_SIZE							16384 // Bytes, see `DELTA_STATE_ARENA`
+#define DELTABASIC_MEMORY_SIZE_CLASSES						10 // Histogram of `delta_SMemoryStats`, 16 bytes to 4 KiB and larger
 
 #define DELTABASIC_PRINT_TAB_SIZE							10
 #define DELTABASIC_PRINT_BUFFER_SIZE						(DELTABASIC_PRINT_TAB_SIZE + 2)
 
 #define DELTABASIC_INPUT_BUFFER_SIZE						64
+#define DELTABASIC_LOAD_BUFFER_SIZE							512 // Line buffer of `delta_Load`, doubled for longer lines
+#define DELTABASIC_IMAGE_READ_CHUNK_SIZE					4096 // Bytes, sections of `delta_LoadImage` grow by the data read, see `ReadChunked`
 
 #define DELTABASIC_NUMERIC_EPSILON							0.0001f
 
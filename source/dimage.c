@@ -0,0 +1,659 @@
+/**
+ * \file	dimage.c
+ * \brief	Compiled program images, see `delta_SaveImage`
+ * \date	17 oct 2026
+ * \author	Reklov
+ */
+#include "dimage.h"
+
+#include <string.h>
+
+#include "deltabasic.h"
+#include "deltabasic_config.h"
+#include "dstate.h"
+#include "dstring.h"
+#include "dmemory.h"
+#include "dcompiler.h"
+#include "dopcodes.h"
+#include "dverifier.h"
+
+#define WriteAssert(exp) { if ((exp) == dfalse) { return DELTA_WRITE_ERROR; }}
+#define ReadAssert(exp) { if ((exp) == dfalse) { return DELTA_IMAGE_INVALID; }}
+#define ImageStatusAssert(exp) { delta_EStatus status = (exp); if (status != DELTA_OK) { return status; }}
+
+// ******************************************************************************** //
+
+/**
+ * delta_SImageReader
+ */
+typedef struct delta_SImageReader {
+	delta_TReadFunction	readFunc;
+
+	delta_TByte*		buffer; // Sections copied again after reading
+	size_t				bufferSize;
+
+	delta_TWord*		cfunctions; // Index in `D->cfuncVector` of every C function of the image
+	size_t				cfunctionCount;
+} delta_SImageReader;
+
+// ******************************************************************************** //
+
+/**
+ * Write [`data`; `data + size`)
+ */
+static delta_TBool	Write(delta_TWriteFunction writeFunc, const void* data, size_t size);
+
+/**
+ * Read exactly `size` bytes to `data`
+ */
+static delta_TBool	Read(delta_SImageReader* R, void* data, size_t size);
+
+/**
+ * Read `size` bytes to `R->buffer`, growing it if needed
+ */
+static delta_EStatus ReadToBuffer(delta_SState* D, delta_SImageReader* R, size_t size);
+
+/**
+ * Read `size` bytes to `*buffer` at `offset`. The buffer grows with the data actually read,
+ * so a size out of a corrupt image fails at the end of the file instead of allocating it
+ */
+static delta_EStatus ReadChunked(delta_SState* D, delta_SImageReader* R, delta_TByte** buffer, size_t* bufferSize, size_t offset, size_t size);
+
+/**
+ * Read the sections after `header` into `D`, which must not have a program
+ */
+static delta_EStatus LoadImage(delta_SState* D, delta_SImageReader* R, const delta_SImageHeader* header);
+
+/**
+ * Map the `OPCODE_CALL` operands of the segment of `line` to the C functions of `D`.
+ * The rest of the segment is checked by `delta_VerifyLine`
+ */
+static delta_TBool	MapCFunctions(delta_SState* D, const delta_SImageReader* R, const delta_SLine* line);
+
+/**
+ * Use `image` as the program of `D`, which must not have one
+ */
+static delta_EStatus AttachImage(delta_SState* D, const delta_SStaticImage* image);
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * delta_SaveImage
+ */
+delta_EStatus delta_SaveImage(delta_SState* D, delta_TWriteFunction writeFunc) {
+	if (D == NULL)
+		return DELTA_STATE_IS_NULL;
+
+	if (writeFunc == NULL)
+		return DELTA_FUNC_IS_NULL;
+
+	if (D->bCompiled == dfalse) {
+		ImageStatusAssert(delta_Compile(D));
+	}
+
+	delta_SImageHeader header;
+	memset(&header, 0x00, sizeof(delta_SImageHeader));
+	memcpy(header.magic, DELTA_IMAGE_MAGIC, sizeof(header.magic));
+	header.version		= DELTA_IMAGE_VERSION;
+	header.byteOrder	= DELTA_IMAGE_BYTE_ORDER;
+	header.numberSize	= sizeof(delta_TNumber);
+	header.charSize		= sizeof(delta_TChar);
+
+	for (delta_SLine* line = D->head; line != NULL; line = line->next) {
+		if (line->line > UINT32_MAX)
+			return DELTA_OUT_OF_LINES_RANGE;
+
+		header.bytecodeSize	+= line->bytecodeSize;
+		header.textSize		+= delta_Strlen(line->str);
+	}
+
+	header.lineCount				= D->lineVector.size;
+	header.registerConstantCount	= D->registerConstants.size;
+	header.stringConstantCount		= D->stringConstants.size;
+	header.numericVariableCount		= D->numericSlots.size;
+	header.stringVariableCount		= D->stringSlots.size;
+	header.cfunctionCount			= D->cfuncVector.size;
+
+	WriteAssert(Write(writeFunc, &header, sizeof(delta_SImageHeader)));
+
+	// Segments back to back, without the ones left by replaced lines
+	for (delta_SLine* line = D->head; line != NULL; line = line->next) {
+		WriteAssert(Write(writeFunc, D->bytecode + line->offset, line->bytecodeSize));
+	}
+
+	uint32_t offset = 0;
+	for (delta_SLine* line = D->head; line != NULL; line = line->next) {
+		delta_SImageLine record;
+		record.number		= (uint32_t)(line->line);
+		record.offset		= offset;
+		record.bytecodeSize	= (uint32_t)(line->bytecodeSize);
+		record.textSize		= (uint32_t)delta_Strlen(line->str);
+
+		WriteAssert(Write(writeFunc, &record, sizeof(delta_SImageLine)));
+		offset += record.bytecodeSize;
+	}
+
+	for (delta_SLine* line = D->head; line != NULL; line = line->next) {
+		WriteAssert(Write(writeFunc, line->str, sizeof(delta_TChar) * delta_Strlen(line->str)));
+	}
+
+	WriteAssert(Write(writeFunc, D->registerConstants.values, sizeof(delta_TNumber) * D->registerConstants.size));
+
+	for (size_t i = 0; i < D->stringConstants.size; ++i) {
+		const delta_UStringValue* constant = &(D->stringConstants.strings[i]);
+		const uint32_t size = (uint32_t)DELTA_STRING_SIZE(constant);
+
+		WriteAssert(Write(writeFunc, &size, sizeof(uint32_t)));
+		WriteAssert(Write(writeFunc, DELTA_STRING_DATA(constant), sizeof(delta_TChar) * size));
+	}
+
+	for (size_t i = 0; i < D->numericSlots.size; ++i) {
+		const delta_TChar* name = D->numericSlots.variables[i]->name;
+		const delta_TWord size = (delta_TWord)delta_Strlen(name);
+
+		WriteAssert(Write(writeFunc, &size, sizeof(delta_TWord)));
+		WriteAssert(Write(writeFunc, name, sizeof(delta_TChar) * size));
+	}
+
+	for (size_t i = 0; i < D->stringSlots.size; ++i) {
+		const delta_TChar* name = D->stringSlots.variables[i]->name;
+		const delta_TWord size = (delta_TWord)delta_Strlen(name);
+
+		WriteAssert(Write(writeFunc, &size, sizeof(delta_TWord)));
+		WriteAssert(Write(writeFunc, name, sizeof(delta_TChar) * size));
+	}
+
+	for (size_t i = 0; i < D->cfuncVector.size; ++i) {
+		const delta_SCFunction* func = D->cfuncVector.array[i];
+
+		delta_SImageCFunction record;
+		memset(&record, 0x00, sizeof(delta_SImageCFunction));
+		record.nameSize	= (delta_TWord)delta_Strlen(func->name);
+		record.argCount	= func->argCount;
+		record.argsMask	= func->argsMask;
+		record.retType	= (delta_TByte)(func->retType);
+
+		WriteAssert(Write(writeFunc, &record, sizeof(delta_SImageCFunction)));
+		WriteAssert(Write(writeFunc, func->name, sizeof(delta_TChar) * record.nameSize));
+	}
+
+	return DELTA_OK;
+}
+
+/* ****************************************
+ * delta_LoadImage
+ */
+delta_EStatus delta_LoadImage(delta_SState* D, delta_TReadFunction readFunc) {
+	if (D == NULL)
+		return DELTA_STATE_IS_NULL;
+
+	if (readFunc == NULL)
+		return DELTA_FUNC_IS_NULL;
+
+	delta_SImageReader reader;
+	memset(&reader, 0x00, sizeof(delta_SImageReader));
+	reader.readFunc = readFunc;
+
+	delta_SImageHeader header;
+	if (Read(&reader, &header, sizeof(delta_SImageHeader)) == dfalse)
+		return DELTA_IMAGE_INVALID;
+
+	if (memcmp(header.magic, DELTA_IMAGE_MAGIC, sizeof(header.magic)) != 0)
+		return DELTA_IMAGE_INVALID;
+
+	if ((header.version != DELTA_IMAGE_VERSION) || (header.byteOrder != DELTA_IMAGE_BYTE_ORDER) ||
+		(header.numberSize != sizeof(delta_TNumber)) || (header.charSize != sizeof(delta_TChar)))
+		return DELTA_IMAGE_INCOMPATIBLE;
+
+	delta_New(D);
+
+	const delta_EStatus status = LoadImage(D, &reader, &header);
+
+	if (reader.buffer != NULL)
+		DELTA_Free(D, DELTA_MEMORY_BYTECODE, reader.buffer, reader.bufferSize);
+
+	if (reader.cfunctions != NULL)
+		DELTA_Free(D, DELTA_MEMORY_CFUNCTIONS, reader.cfunctions, sizeof(delta_TWord) * reader.cfunctionCount);
+
+	if (status != DELTA_OK)
+		delta_New(D); // Nothing half loaded
+
+	return status;
+}
+
+/* ****************************************
+ * delta_AttachImage
+ */
+delta_EStatus delta_AttachImage(delta_SState* D, const delta_SStaticImage* image) {
+	if (D == NULL)
+		return DELTA_STATE_IS_NULL;
+
+	if (image == NULL)
+		return DELTA_IMAGE_INVALID;
+
+	if (image->version != DELTA_IMAGE_VERSION)
+		return DELTA_IMAGE_INCOMPATIBLE;
+
+	ImageStatusAssert(delta_New(D));
+
+	const delta_EStatus status = AttachImage(D, image);
+	if (status != DELTA_OK)
+		delta_New(D); // Nothing half attached
+
+	return status;
+}
+
+/* ****************************************
+ * delta_DetachImage
+ */
+delta_TBool delta_DetachImage(delta_SState* D) {
+	delta_TByte* bytecode = (delta_TByte*)DELTA_Alloc(D, DELTA_MEMORY_BYTECODE, sizeof(delta_TByte) * DELTABASIC_COMPILER_INITIAL_BYTECODE_SIZE);
+	if (bytecode == NULL)
+		return dfalse;
+
+	D->bytecode			= bytecode;
+	D->bytecodeSize		= DELTABASIC_COMPILER_INITIAL_BYTECODE_SIZE;
+	D->bytecodeEnd		= 0;
+	D->bytecodeGarbage	= 0;
+	D->bCompiled		= dfalse;
+	D->bAttached		= dfalse;
+
+	memset(&(D->registerConstants), 0x00, sizeof(delta_SRegisterConstants));
+
+	return dtrue;
+}
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * Write
+ */
+delta_TBool Write(delta_TWriteFunction writeFunc, const void* data, size_t size) {
+	if (size == 0)
+		return dtrue;
+
+	return (writeFunc(data, 1, size) == size);
+}
+
+/* ****************************************
+ * Read
+ */
+delta_TBool Read(delta_SImageReader* R, void* data, size_t size) {
+	delta_TByte* out = (delta_TByte*)data;
+	while (size != 0) {
+		const size_t count = R->readFunc(out, 1, size);
+		if (count == 0)
+			return dfalse;
+
+		out		+= count;
+		size	-= count;
+	}
+
+	return dtrue;
+}
+
+/* ****************************************
+ * ReadToBuffer
+ */
+delta_EStatus ReadToBuffer(delta_SState* D, delta_SImageReader* R, size_t size) {
+	return ReadChunked(D, R, &(R->buffer), &(R->bufferSize), 0, size);
+}
+
+/* ****************************************
+ * ReadChunked
+ */
+delta_EStatus ReadChunked(delta_SState* D, delta_SImageReader* R, delta_TByte** buffer, size_t* bufferSize, size_t offset, size_t size) {
+	size_t done = 0;
+	while (done < size) {
+		const size_t chunk = DELTABASIC_MIN(size - done, DELTABASIC_MAX(done, (size_t)DELTABASIC_IMAGE_READ_CHUNK_SIZE));
+
+		const size_t end = offset + done + chunk;
+		if (end > *bufferSize) { // Not realloc, a failure keeps the buffer
+			delta_TByte* newBuffer = (delta_TByte*)DELTA_Alloc(D, DELTA_MEMORY_BYTECODE, end);
+			if (newBuffer == NULL)
+				return DELTA_ALLOCATOR_ERROR;
+
+			if (*buffer != NULL) {
+				memcpy(newBuffer, *buffer, offset + done);
+				DELTA_Free(D, DELTA_MEMORY_BYTECODE, *buffer, *bufferSize);
+			}
+
+			*buffer		= newBuffer;
+			*bufferSize	= end;
+		}
+
+		ReadAssert(Read(R, *buffer + offset + done, chunk));
+		done += chunk;
+	}
+
+	return DELTA_OK;
+}
+
+/* ****************************************
+ * LoadImage
+ */
+delta_EStatus LoadImage(delta_SState* D, delta_SImageReader* R, const delta_SImageHeader* header) {
+	if ((header->registerConstantCount > (size_t)DELTA_REGISTER_INDEX_MASK + 1) ||
+		(header->stringConstantCount > (size_t)DELTA_STRING_CONSTANT_INDEX_MASK + 1) ||
+		(header->numericVariableCount > (size_t)UINT16_MAX + 1) ||
+		(header->stringVariableCount > (size_t)UINT16_MAX + 1) ||
+		(header->cfunctionCount > (size_t)UINT16_MAX + 1))
+		return DELTA_IMAGE_INVALID;
+
+	// Counts the sections they describe can't hold: every line has a segment and a text,
+	// every constant is an operand of the bytecode or a literal of a text, and every C function
+	// maps to one of `D`
+	if ((header->lineCount > header->bytecodeSize) ||
+		(header->textSize > (uint64_t)(header->lineCount) * DELTABASIC_MAX_LINE_SIZE) ||
+		(header->registerConstantCount > header->bytecodeSize) ||
+		(header->stringConstantCount > header->textSize) ||
+		(header->cfunctionCount > D->cfuncVector.size))
+		return DELTA_IMAGE_INVALID;
+
+	// Bytecode
+	ImageStatusAssert(ReadChunked(D, R, &(D->bytecode), &(D->bytecodeSize), 0, header->bytecodeSize));
+	const size_t bytecodeSize = header->bytecodeSize;
+
+	// Lines, with their texts
+	const size_t tableSize = sizeof(delta_SImageLine) * header->lineCount;
+	ImageStatusAssert(ReadToBuffer(D, R, tableSize + sizeof(delta_TChar) * header->textSize));
+
+	const delta_SImageLine* records = (const delta_SImageLine*)(R->buffer);
+	const delta_TChar* text = (const delta_TChar*)(R->buffer + tableSize);
+
+	size_t textOffset = 0;
+	for (size_t i = 0; i < header->lineCount; ++i) {
+		const delta_SImageLine* record = &(records[i]);
+		if ((i != 0) && (record->number <= records[i - 1].number))
+			return DELTA_IMAGE_INVALID;
+
+		if ((record->bytecodeSize == 0) || (record->offset > header->bytecodeSize) || (record->bytecodeSize > header->bytecodeSize - record->offset))
+			return DELTA_IMAGE_INVALID;
+
+		if ((record->textSize == 0) || (record->textSize > DELTABASIC_MAX_LINE_SIZE) || (record->textSize > header->textSize - textOffset))
+			return DELTA_IMAGE_INVALID;
+
+		for (size_t c = 0; c < record->textSize; ++c) {
+			if (text[textOffset + c] == '\0')
+				return DELTA_IMAGE_INVALID;
+		}
+
+		if (delta_InsertLine(D, record->number, text + textOffset, record->textSize) == dfalse)
+			return DELTA_ALLOCATOR_ERROR;
+
+		D->tail->offset			= record->offset;
+		D->tail->bytecodeSize	= record->bytecodeSize;
+
+		textOffset += record->textSize;
+	}
+
+	if (textOffset != header->textSize)
+		return DELTA_IMAGE_INVALID;
+
+	// Register constants, straight into the pool
+	if (header->registerConstantCount != 0) {
+		delta_SRegisterConstants* pool = &(D->registerConstants);
+
+		pool->values = (delta_TNumber*)DELTA_Alloc(D, DELTA_MEMORY_BYTECODE, sizeof(delta_TNumber) * header->registerConstantCount);
+		if (pool->values == NULL)
+			return DELTA_ALLOCATOR_ERROR;
+
+		pool->allocated = header->registerConstantCount;
+
+		ReadAssert(Read(R, pool->values, sizeof(delta_TNumber) * header->registerConstantCount));
+		pool->size = header->registerConstantCount;
+	}
+
+	// String constants
+	delta_SStringConstants* constants = &(D->stringConstants);
+	if (header->stringConstantCount > constants->allocated) {
+		delta_UStringValue* strings = (delta_UStringValue*)DELTA_Alloc(D, DELTA_MEMORY_STRINGS, sizeof(delta_UStringValue) * header->stringConstantCount);
+		if (strings == NULL)
+			return DELTA_ALLOCATOR_ERROR;
+
+		if (constants->allocated != 0)
+			DELTA_Free(D, DELTA_MEMORY_STRINGS, constants->strings, sizeof(delta_UStringValue) * constants->allocated);
+
+		constants->strings		= strings;
+		constants->allocated	= header->stringConstantCount;
+	}
+
+	for (size_t i = 0; i < header->stringConstantCount; ++i) {
+		uint32_t size = 0;
+		ReadAssert(Read(R, &size, sizeof(uint32_t)));
+
+		if (size > DELTABASIC_MAX_LINE_SIZE) // A literal of a line
+			return DELTA_IMAGE_INVALID;
+
+		ImageStatusAssert(ReadToBuffer(D, R, sizeof(delta_TChar) * size));
+
+		if (delta_CreateStringValue(D, &(constants->strings[constants->size]), (const delta_TChar*)(R->buffer), size) == dfalse)
+			return DELTA_ALLOCATOR_ERROR;
+
+		++(constants->size);
+	}
+
+	// Variables, getting the same slots
+	for (size_t i = 0; i < header->numericVariableCount + header->stringVariableCount; ++i) {
+		delta_TWord size = 0;
+		ReadAssert(Read(R, &size, sizeof(delta_TWord)));
+		ImageStatusAssert(ReadToBuffer(D, R, sizeof(delta_TChar) * size));
+
+		if (size == 0)
+			return DELTA_IMAGE_INVALID;
+
+		const delta_TChar* name = (const delta_TChar*)(R->buffer);
+		size_t slot = 0;
+		if (i < header->numericVariableCount) {
+			delta_SNumericVariable* var = delta_FindOrAddNumericVariable(D, name, size);
+			if (var == NULL)
+				return DELTA_ALLOCATOR_ERROR;
+
+			slot = var->slot;
+		}
+		else {
+			delta_SStringVariable* var = delta_FindOrAddStringVariable(D, name, size);
+			if (var == NULL)
+				return DELTA_ALLOCATOR_ERROR;
+
+			slot = var->slot + header->numericVariableCount;
+		}
+
+		if (slot != i) // Same name twice
+			return DELTA_IMAGE_INVALID;
+	}
+
+	// C functions, by name
+	if (header->cfunctionCount != 0) {
+		R->cfunctions = (delta_TWord*)DELTA_Alloc(D, DELTA_MEMORY_CFUNCTIONS, sizeof(delta_TWord) * header->cfunctionCount);
+		if (R->cfunctions == NULL)
+			return DELTA_ALLOCATOR_ERROR;
+
+		R->cfunctionCount = header->cfunctionCount;
+	}
+
+	for (size_t i = 0; i < header->cfunctionCount; ++i) {
+		delta_SImageCFunction record;
+		ReadAssert(Read(R, &record, sizeof(delta_SImageCFunction)));
+		ImageStatusAssert(ReadToBuffer(D, R, sizeof(delta_TChar) * record.nameSize));
+
+		size_t index = 0;
+		if (delta_FindCFunction(D, (const delta_TChar*)(R->buffer), record.nameSize, &index) == dfalse)
+			return DELTA_IMAGE_INCOMPATIBLE;
+
+		const delta_SCFunction* func = D->cfuncVector.array[index];
+		if ((func->argCount != record.argCount) || (func->argsMask != record.argsMask) || (func->retType != (delta_ECFuncArgType)(record.retType)))
+			return DELTA_IMAGE_INCOMPATIBLE;
+
+		R->cfunctions[i] = (delta_TWord)index;
+	}
+
+	for (delta_SLine* line = D->head; line != NULL; line = line->next) {
+		if (MapCFunctions(D, R, line) == dfalse)
+			return DELTA_IMAGE_INVALID;
+	}
+
+	if (delta_VerifyProgram(D) == dfalse)
+		return DELTA_IMAGE_INVALID;
+
+	D->bCompiled		= dtrue;
+	D->bytecodeEnd		= bytecodeSize;
+	D->bytecodeGarbage	= 0;
+
+	// Jump operands hold line numbers, the line indices are resolved again
+	for (delta_SLine* line = D->head; line != NULL; line = line->next) {
+		if (delta_Link(D, D->bytecode, line->offset, line->offset + line->bytecodeSize) != DELTA_OK)
+			return DELTA_IMAGE_INVALID;
+	}
+
+	D->ip			= (D->head != NULL) ? D->head->offset : 0;
+	D->currentLine	= D->head;
+
+	return DELTA_OK;
+}
+
+/* ****************************************
+ * AttachImage
+ */
+delta_EStatus AttachImage(delta_SState* D, const delta_SStaticImage* image) {
+	if ((image->registerConstantCount > (size_t)DELTA_REGISTER_INDEX_MASK + 1) ||
+		(image->stringConstantCount > (size_t)DELTA_STRING_CONSTANT_INDEX_MASK + 1) ||
+		(image->numericVariableCount > (size_t)UINT16_MAX + 1) ||
+		(image->stringVariableCount > (size_t)UINT16_MAX + 1) ||
+		(image->cfunctionCount > D->cfuncVector.size))
+		return DELTA_IMAGE_INCOMPATIBLE;
+
+	// Bytecode and register constants in place
+	DELTA_Free(D, DELTA_MEMORY_BYTECODE, D->bytecode, sizeof(delta_TByte) * D->bytecodeSize);
+
+	D->bytecode						= (delta_TByte*)(image->bytecode); // Never written while `bAttached`
+	D->bytecodeSize					= 0;
+	D->bAttached					= dtrue;
+	D->registerConstants.values		= (delta_TNumber*)(image->registerConstants);
+	D->registerConstants.size		= image->registerConstantCount;
+	D->registerConstants.allocated	= 0;
+
+	// Lines, with copies of their texts
+	for (size_t i = 0; i < image->lineCount; ++i) {
+		const delta_SStaticImageLine* record = &(image->lines[i]);
+		if ((i != 0) && (record->number <= image->lines[i - 1].number))
+			return DELTA_IMAGE_INVALID;
+
+		if ((record->bytecodeSize == 0) || (record->offset > image->bytecodeSize) || (record->bytecodeSize > image->bytecodeSize - record->offset))
+			return DELTA_IMAGE_INVALID;
+
+		const size_t textSize = delta_Strlen(record->text);
+		if (textSize == 0)
+			return DELTA_IMAGE_INVALID;
+
+		if (delta_InsertLine(D, record->number, record->text, textSize) == dfalse)
+			return DELTA_ALLOCATOR_ERROR;
+
+		D->tail->offset			= record->offset;
+		D->tail->bytecodeSize	= record->bytecodeSize;
+	}
+
+	// String constants
+	delta_SStringConstants* constants = &(D->stringConstants);
+	if (image->stringConstantCount > constants->allocated) {
+		delta_UStringValue* strings = (delta_UStringValue*)DELTA_Alloc(D, DELTA_MEMORY_STRINGS, sizeof(delta_UStringValue) * image->stringConstantCount);
+		if (strings == NULL)
+			return DELTA_ALLOCATOR_ERROR;
+
+		if (constants->allocated != 0)
+			DELTA_Free(D, DELTA_MEMORY_STRINGS, constants->strings, sizeof(delta_UStringValue) * constants->allocated);
+
+		constants->strings		= strings;
+		constants->allocated	= image->stringConstantCount;
+	}
+
+	for (size_t i = 0; i < image->stringConstantCount; ++i) {
+		const delta_TChar* str = image->stringConstants[i];
+		if (delta_CreateStringValue(D, &(constants->strings[constants->size]), str, delta_Strlen(str)) == dfalse)
+			return DELTA_ALLOCATOR_ERROR;
+
+		++(constants->size);
+	}
+
+	// Variables, getting the same slots
+	for (size_t i = 0; i < image->numericVariableCount; ++i) {
+		const delta_TChar* name = image->numericVariables[i];
+		const size_t size = delta_Strlen(name);
+		if ((size == 0) || (size > UINT16_MAX))
+			return DELTA_IMAGE_INVALID;
+
+		delta_SNumericVariable* var = delta_FindOrAddNumericVariable(D, name, (uint16_t)size);
+		if (var == NULL)
+			return DELTA_ALLOCATOR_ERROR;
+
+		if (var->slot != i)
+			return DELTA_IMAGE_INVALID;
+	}
+
+	for (size_t i = 0; i < image->stringVariableCount; ++i) {
+		const delta_TChar* name = image->stringVariables[i];
+		const size_t size = delta_Strlen(name);
+		if ((size == 0) || (size > UINT16_MAX))
+			return DELTA_IMAGE_INVALID;
+
+		delta_SStringVariable* var = delta_FindOrAddStringVariable(D, name, (uint16_t)size);
+		if (var == NULL)
+			return DELTA_ALLOCATOR_ERROR;
+
+		if (var->slot != i)
+			return DELTA_IMAGE_INVALID;
+	}
+
+	// C functions, by index since the bytecode can't be mapped
+	for (size_t i = 0; i < image->cfunctionCount; ++i) {
+		const delta_SStaticImageCFunction* record = &(image->cfunctions[i]);
+		const delta_SCFunction* func = D->cfuncVector.array[i];
+
+		if (strcmp(func->name, record->name) != 0)
+			return DELTA_IMAGE_INCOMPATIBLE;
+
+		if ((func->argCount != record->argCount) || (func->argsMask != record->argsMask) || (func->retType != record->retType))
+			return DELTA_IMAGE_INCOMPATIBLE;
+	}
+
+	if (delta_VerifyProgram(D) == dfalse)
+		return DELTA_IMAGE_INVALID;
+
+	// Already linked by `dbasc`
+	D->bCompiled		= dtrue;
+	D->bytecodeEnd		= image->bytecodeSize;
+	D->bytecodeGarbage	= 0;
+
+	D->ip			= (D->head != NULL) ? D->head->offset : 0;
+	D->currentLine	= D->head;
+
+	return DELTA_OK;
+}
+
+/* ****************************************
+ * MapCFunctions
+ */
+delta_TBool MapCFunctions(delta_SState* D, const delta_SImageReader* R, const delta_SLine* line) {
+	const size_t end = line->offset + line->bytecodeSize;
+
+	size_t ip = line->offset;
+	while (ip < end) {
+		const delta_TByte opcode = D->bytecode[ip];
+
+		const size_t size = delta_GetOpcodeSize(opcode);
+		if ((size == 0) || (size > end - ip))
+			return dfalse;
+
+		if ((opcode == OPCODE_CALL) || (opcode == OPCODE_CALLR)) {
+			delta_TWord* operand = (delta_TWord*)(D->bytecode + ip + 1);
+			if (*operand >= R->cfunctionCount)
+				return dfalse;
+
+			*operand = R->cfunctions[*operand];
+		}
+
+		ip += size;
+	}
+
+	return dtrue;
+}
@@ -0,0 +1,84 @@
+/**
+ * \file	dimage.h
+ * \brief	Compiled program images, see `delta_SaveImage`
+ * \date	17 oct 2026
+ * \author	Reklov
+ */
+#ifndef __DELTABASIC_IMAGE_H__
+#define __DELTABASIC_IMAGE_H__
+
+#include <stdint.h>
+
+#include "deltabasic.h"
+#include "dlimits.h"
+
+#define DELTA_IMAGE_MAGIC									"DBC" // With the null-terminal
+#define DELTA_IMAGE_VERSION									1
+#define DELTA_IMAGE_BYTE_ORDER								0x01020304
+
+// ******************************************************************************** //
+
+/**
+ * delta_SImageHeader
+ *
+ * Start of an image, followed by its sections in this order:
+ * - bytecode of the lines, `bytecodeSize` bytes
+ * - `delta_SImageLine` of every line, in order
+ * - texts of the lines, `textSize` characters without null-terminals
+ * - register constants, `delta_TNumber` each
+ * - string constants, a `uint32_t` size then the characters each
+ * - names of the numeric variables then of the string variables in slot order, a `delta_TWord` size then the characters each
+ * - `delta_SImageCFunction` of every C function, followed by its name
+ *
+ * Values are in the byte order of the machine that saved the image
+ */
+typedef struct delta_SImageHeader {
+	char			magic[4]; // `DELTA_IMAGE_MAGIC`
+	uint32_t		version; // `DELTA_IMAGE_VERSION`
+	uint32_t		byteOrder; // `DELTA_IMAGE_BYTE_ORDER`
+	delta_TByte		numberSize; // Of `delta_TNumber`
+	delta_TByte		charSize; // Of `delta_TChar`
+	delta_TWord		reserved;
+
+	uint32_t		bytecodeSize;
+	uint32_t		lineCount;
+	uint32_t		textSize;
+	uint32_t		registerConstantCount;
+	uint32_t		stringConstantCount;
+	uint32_t		numericVariableCount;
+	uint32_t		stringVariableCount;
+	uint32_t		cfunctionCount;
+} delta_SImageHeader;
+
+/**
+ * delta_SImageLine
+ */
+typedef struct delta_SImageLine {
+	uint32_t		number;
+	uint32_t		offset; // Of its segment in the bytecode section
+	uint32_t		bytecodeSize;
+	uint32_t		textSize;
+} delta_SImageLine;
+
+/**
+ * delta_SImageCFunction
+ *
+ * `OPCODE_CALL` operands are indices of these, mapped to the C functions of the loading state by name
+ */
+typedef struct delta_SImageCFunction {
+	delta_TWord		nameSize;
+	delta_TByte		argCount;
+	delta_TByte		argsMask; // `delta_TCFuncArgMask`
+	delta_TByte		retType; // `delta_ECFuncArgType`
+	delta_TByte		reserved[3];
+} delta_SImageCFunction;
+
+// ******************************************************************************** //
+
+/**
+ * Give `D` a bytecode buffer of its own in place of the one of a `delta_AttachImage` image.
+ * The program must be compiled again
+ */
+delta_TBool			delta_DetachImage(delta_SState* D);
+
+#endif /* !__DELTABASIC_IMAGE_H__ */
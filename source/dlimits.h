@@ -29,5 +29,6 @@ typedef long												delta_TInteger;
 typedef delta_TByte											delta_TCFuncArgMask;
 
 #define DELTABASIC_CFUNC_MAX_ARGS							(sizeof(delta_TCFuncArgMask) * 8)
+#define DELTABASIC_MAX_LINE_SIZE							UINT16_MAX // Characters, the compiler writes offsets in the text of a line as `delta_TWord`
 
 #endif /* !__DELTABASIC_LIMITS_H__ */
\ No newline at end of file
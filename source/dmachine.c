@@ -6,8 +6,10 @@
  */
 #include "dmachine.h"
 
+#include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
 
 #include "dmemory.h"
 #include "dstate.h"
@@ -17,39 +19,214 @@
 
 #include "dcompiler.h"
 
-#define DELTA_MACHINE_CHECK_IS_COMPILED()					\
-	if (D->bCompiled == dfalse) {							\
-		delta_EStatus status = delta_Compile(D);			\
+#if (DELTABASIC_MACHINE_COMPUTED_GOTO != 0) && defined(__GNUC__) && !defined(__EMSCRIPTEN__)
+	#define DELTA_MACHINE_THREADED
+#endif
+
+#define DELTA_MACHINE_DISPATCH_TABLE_SIZE					256 // Every `delta_TByte` value
+#define DELTA_MACHINE_SAMPLE_SIZE							((DELTABASIC_RETURN_STACK_SIZE + 1) * 24) // Folded stack of `TakeSample`, line numbers of up to 20 digits
+
+// ******************************************************************************** //
+
+/**
+ * Interpreter loop helpers.
+ *
+ * `ip`, `line` and the stack heads live in locals of `delta_ExecuteInstructions`
+ * and are written back to the state only on exit, on error or around the calls
+ * of the out-of-line handlers below.
+ */
+#define DELTA_MACHINE_BYTECODE(D, line)						(((line) == (D)->execLine) ? (D)->execBytecode : (D)->bytecode)
+
+#define DELTA_MACHINE_SAVE() {								\
+		D->ip			= ip;								\
+		D->currentLine	= line;								\
+		D->numericHead	= numericHead;						\
+		D->stringHead	= stringHead;						\
+	}
+
+#define DELTA_MACHINE_LOAD() {								\
+		ip				= D->ip;							\
+		line			= D->currentLine;					\
+		numericHead		= D->numericHead;					\
+		stringHead		= D->stringHead;					\
+		bytecode		= DELTA_MACHINE_BYTECODE(D, line);	\
+		numericValues	= D->numericSlots.values;			\
+		registerBanks[DELTA_REGISTER_VARIABLES] = D->numericSlots.values;		\
+		registerBanks[DELTA_REGISTER_CONSTANTS] = D->registerConstants.values;	\
+	}
+
+#define DELTA_MACHINE_ERROR(exp) { status = (exp); goto machine_error; }
+
+#define DELTA_MACHINE_CALL(func) {							\
+		DELTA_MACHINE_SAVE();								\
+		status = func(D);									\
 		if (status != DELTA_OK)								\
-			return status;									\
+			goto machine_failed;							\
+		DELTA_MACHINE_LOAD();								\
 	}
 
-// ******************************************************************************** //
+#define DELTA_MACHINE_CHECK_IS_COMPILED() {					\
+		if (D->bCompiled == dfalse) {						\
+			DELTA_MACHINE_SAVE();							\
+			status = delta_Compile(D);						\
+			if (status != DELTA_OK)							\
+				goto machine_failed;						\
+			DELTA_MACHINE_LOAD();							\
+		}													\
+	}
+
+// Compile the program edited since the last compile and go on at the start of line `number`
+#define DELTA_MACHINE_RECOMPILE(number) {					\
+		DELTA_MACHINE_SAVE();								\
+		status = MachineRecompile(D, (number));				\
+		if (status != DELTA_OK)								\
+			goto machine_failed;							\
+		DELTA_MACHINE_LOAD();								\
+	}
+
+// Go to the target of the `OPCODE_JMP` or `OPCODE_GOSUB` operands at `ip`, their line index
+// from `delta_Link` is stale if the program has been edited since
+#define DELTA_MACHINE_JUMP() {								\
+		if (D->bCompiled == dfalse)							\
+			DELTA_MACHINE_RECOMPILE(DELTA_MACHINE_DWORD(0))	\
+		else {												\
+			line		= D->lineVector.array[DELTA_MACHINE_DWORD(1)];	\
+			ip			= line->offset;						\
+			bytecode	= D->bytecode;						\
+		}													\
+	}
+
+// Go to the line after `line`, not compiled yet if it has been inserted since the last compile
+#define DELTA_MACHINE_FALL_THROUGH() {						\
+		line = line->next;									\
+		if (line != NULL) {									\
+			if (D->bCompiled == dfalse)						\
+				DELTA_MACHINE_RECOMPILE(line->line)			\
+			else											\
+				ip = line->offset;							\
+		}													\
+	}
+
+#define DELTA_MACHINE_WORD(index)							(((delta_TWord*)(bytecode + ip))[index])
+#define DELTA_MACHINE_DWORD(index)							(((delta_TDWord*)(bytecode + ip))[index])
+#define DELTA_MACHINE_NUMBER()								(*((delta_TNumber*)(bytecode + ip)))
+#define DELTA_MACHINE_OPERAND(type, offset)					(*((type*)(bytecode + ip + (offset))))
+#define DELTA_MACHINE_REGISTER(operand)						(registerBanks[(operand) >> DELTA_REGISTER_BANK_SHIFT][(operand) & DELTA_REGISTER_INDEX_MASK])
+#define DELTA_MACHINE_RWORD(index)							DELTA_MACHINE_REGISTER(DELTA_MACHINE_WORD(index))
+
+#if (DELTABASIC_MACHINE_PROFILER != 0)
+	// Count the instruction at `ip` on its line and opcode, see `DELTA_STATE_PROFILE`
+	#define DELTA_MACHINE_PROFILE() {						\
+			++(line->profile.instructions);					\
+			++(D->opcodeProfile[bytecode[ip]].instructions);	\
+			if (bProfileTime == dtrue)						\
+				ProfileStart(D, &profileTimer, line, bytecode[ip]);	\
+		}
+
+	#define DELTA_MACHINE_PROFILE_STOP() {					\
+			if (bProfileTime == dtrue)						\
+				ProfileStop(D, &profileTimer);				\
+		}
+#else
+	#define DELTA_MACHINE_PROFILE_STOP()
+#endif
+
+#if (DELTABASIC_MACHINE_SAMPLER != 0)
+	// Take the sample asked by `delta_RequestSample`, by the opcodes leaving `line` before they do
+	#define DELTA_MACHINE_SAMPLE() {						\
+			if ((bSample == dtrue) && (D->bSampleRequested != 0)) {	\
+				status = TakeSample(D, line);				\
+				if (status != DELTA_OK)						\
+					DELTA_MACHINE_ERROR(status);			\
+			}												\
+		}
+#else
+	#define DELTA_MACHINE_SAMPLE()
+#endif
+
+#ifdef DELTA_MACHINE_THREADED
+	#define DELTA_MACHINE_OPCODE(op)						case op: machine_##op:
+	#define DELTA_MACHINE_OPCODE_DEFAULT()					default: machine_unknown:
+	#define DELTA_MACHINE_DISPATCH()						goto *dispatch[bytecode[ip]]
+#else
+	#define DELTA_MACHINE_OPCODE(op)						case op:
+	#define DELTA_MACHINE_OPCODE_DEFAULT()					default:
+	#define DELTA_MACHINE_DISPATCH()						continue
+#endif
+
+#define DELTA_MACHINE_NEXT() {								\
+		if (--budget == 0)									\
+			goto machine_exit;								\
+		DELTA_MACHINE_DISPATCH();							\
+	}
+
+// A superinstruction is charged as the `count` instructions it replaced,
+// `DELTA_MACHINE_NEXT` charges the last one. The slice can end past the budget
+#define DELTA_MACHINE_CHARGE(count) {						\
+		budget = (budget > (count)) ? (budget - ((count) - 1)) : 1;	\
+	}
 
-delta_EStatus MachineHalt(delta_SState* D);
-delta_EStatus MachineNextLine(delta_SState* D);
+// Same as `DELTA_MACHINE_NEXT`, but for opcodes that can leave the program
+#define DELTA_MACHINE_NEXT_LINE() {							\
+		if (--budget == 0)									\
+			goto machine_exit;								\
+		if (line == NULL)									\
+			goto machine_end;								\
+		DELTA_MACHINE_DISPATCH();							\
+	}
 
 // ******************************************************************************** //
 
-delta_EStatus MachinePushNumeric(delta_SState* D);
-delta_EStatus MachineSetNumeric(delta_SState* D);
-delta_EStatus MachineGetNumeric(delta_SState* D);
+/**
+ * Compile the edited program and go to the start of line `number`, see `DELTA_MACHINE_RECOMPILE`
+ */
+static delta_EStatus MachineRecompile(delta_SState* D, size_t number);
+
+#if (DELTABASIC_MACHINE_PROFILER != 0)
+/**
+ * delta_SProfileTimer
+ *
+ * Instruction running with `DELTA_STATE_PROFILE_TIME`, charged with the time until the next one starts
+ */
+typedef struct delta_SProfileTimer {
+	delta_SLine*		line; // `NULL` before the first instruction
+	delta_TByte			opcode;
+	unsigned long long	start; // See `ProfileClock`
+} delta_SProfileTimer;
+
+/**
+ * Monotonic time in nanoseconds
+ */
+static unsigned long long ProfileClock(void);
+
+/**
+ * Charge the instruction of `T` and start timing `opcode` of `line`
+ */
+static void			ProfileStart(delta_SState* D, delta_SProfileTimer* T, delta_SLine* line, delta_TByte opcode);
+
+/**
+ * Charge the instruction of `T`, when leaving the loop
+ */
+static void			ProfileStop(delta_SState* D, delta_SProfileTimer* T);
+#endif
+
+#if (DELTABASIC_MACHINE_SAMPLER != 0)
+/**
+ * Count a sample of `line` called from the lines of the return stack
+ */
+static delta_EStatus TakeSample(delta_SState* D, const delta_SLine* line);
+#endif
 
 // ******************************************************************************** //
 
-delta_EStatus MachinePushString(delta_SState* D);
 delta_EStatus MachineSetString(delta_SState* D);
 delta_EStatus MachineGetString(delta_SState* D);
 
 // ******************************************************************************** //
 
 delta_EStatus MachineConcat(delta_SState* D);
-delta_EStatus MachineAdd(delta_SState* D);
-delta_EStatus MachineSub(delta_SState* D);
-delta_EStatus MachineMul(delta_SState* D);
-delta_EStatus MachineDiv(delta_SState* D);
-delta_EStatus MachineMod(delta_SState* D);
-delta_EStatus MachinePow(delta_SState* D);
+delta_EStatus MachineConcatN(delta_SState* D);
+delta_EStatus MachineAppendString(delta_SState* D);
 
 // ******************************************************************************** //
 
@@ -61,31 +238,10 @@ delta_EStatus MachinePrintNewLine(delta_SState* D);
 
 // ******************************************************************************** //
 
-delta_EStatus MachineEqualTo(delta_SState* D);
-delta_EStatus MachineNotEqualTo(delta_SState* D);
-delta_EStatus MachineLessThan(delta_SState* D);
-delta_EStatus MachineGreaterThan(delta_SState* D);
-delta_EStatus MachineLessOrEqualTo(delta_SState* D);
-delta_EStatus MachineGreaterOrEqualTo(delta_SState* D);
-
-// ******************************************************************************** //
-
-delta_EStatus MachineNeg(delta_SState* D);
-
-// ******************************************************************************** //
-
-delta_EStatus MachineStop(delta_SState* D);
-delta_EStatus MachineRun(delta_SState* D);
-delta_EStatus MachineJump(delta_SState* D);
-delta_EStatus MachineGoSub(delta_SState* D);
-delta_EStatus MachineReturn(delta_SState* D);
-delta_EStatus MachineJumpNextLineIfNotZero(delta_SState* D);
-
-// ******************************************************************************** //
-
-delta_EStatus MachineSetFor(delta_SState* D);
-delta_EStatus MachineSetStepFor(delta_SState* D);
-delta_EStatus MachineNextFor(delta_SState* D);
+delta_EStatus MachinePrintNumericVariable(delta_SState* D);
+delta_EStatus MachinePrintNumericVariableT(delta_SState* D);
+delta_EStatus MachinePrintStringVariable(delta_SState* D);
+delta_EStatus MachinePrintStringVariableT(delta_SState* D);
 
 // ******************************************************************************** //
 
@@ -104,12 +260,7 @@ delta_EStatus MachineAllocStringArray(delta_SState* D);
 
 // ******************************************************************************** //
 
-delta_EStatus MachineGetNumericArray(delta_SState* D);
 delta_EStatus MachineGetStringArray(delta_SState* D);
-
-// ******************************************************************************** //
-
-delta_EStatus MachineSetNumericArray(delta_SState* D);
 delta_EStatus MachineSetStringArray(delta_SState* D);
 
 // ******************************************************************************** //
@@ -130,800 +281,1268 @@ size_t FormatNumeric(delta_TChar str[], size_t strSize, delta_TNumber number);
 size_t PrintTabs(delta_SState* D, size_t size);
 
 /**
- * CopyStringToStack
- * 
- * \warning DOES NOT CHECK STACK OVERFLOW
+ * PrintNumber
+ *
+ * \return printed size
  */
-delta_TBool CopyStringToStack(delta_SState* D, delta_TChar str[]);
+size_t PrintNumber(delta_SState* D, delta_TNumber number);
 
-// ******************************************************************************** //
+/**
+ * Comparison opcode (`OPCODE_ET` to `OPCODE_GET`) applied to `a` and `b`
+ */
+delta_TBool CompareNumbers(delta_TByte comparison, delta_TNumber a, delta_TNumber b);
 
 /**
- * VM function
+ * Push a new reference to `str`
+ * 
+ * \warning DOES NOT CHECK STACK OVERFLOW
  */
-typedef delta_EStatus(*TMachineFunction)(delta_SState* D);
+void PushStringToStack(delta_SState* D, const delta_UStringValue* str);
 
 /**
- * Opcode to VM function
+ * Replace the top `count` strings of the stack with their concatenation,
+ * built in the first one
  */
-static const TMachineFunction machine_functions[OPCODE_COUNT] = {
-	MachineHalt,
-	MachineNextLine,
-	MachinePushString,
-	MachinePushNumeric,
-	MachineConcat,
-	MachineAdd,
-	MachineSub,
-	MachineMul,
-	MachineDiv,
-	MachineMod,
-	MachinePow,
-	MachineSetNumeric,
-	MachineSetString,
-	MachineJump,
-	MachinePrintNumeric,
-	MachinePrintNumericT,
-	MachinePrintString,
-	MachinePrintStringT,
-	MachinePrintNewLine,
-	MachineGetNumeric,
-	MachineGetString,
-	MachineEqualTo,
-	MachineNotEqualTo,
-	MachineLessThan,
-	MachineGreaterThan,
-	MachineLessOrEqualTo,
-	MachineGreaterOrEqualTo,
-	MachineNeg,
-	MachineStop,
-	MachineRun,
-	MachineGoSub,
-	MachineReturn,
-	MachineJumpNextLineIfNotZero,
-	MachineSetFor,
-	MachineSetStepFor,
-	MachineNextFor,
-	MachineInputNumeric,
-	MachineInputString,
-	MachineAllocNumericArray,
-	MachineAllocStringArray,
-	MachineGetNumericArray,
-	MachineGetStringArray,
-	MachineSetNumericArray,
-	MachineSetStringArray,
-	MachineCall,
-	MachineCallReturn,
-};
+delta_EStatus ConcatStrings(delta_SState* D, size_t count);
 
 // ******************************************************************************** //
 
 /* ****************************************
- * delta_ExecuteInstruction
+ * delta_ExecuteInstructions
  */
-delta_EStatus delta_ExecuteInstruction(delta_SState* D) {
+delta_EStatus delta_ExecuteInstructions(delta_SState* D, size_t nInstructions) {
 	if (D->currentLine == NULL) {
 		delta_FreeStringStack(D);
 		return DELTA_END;
 	}
 
-	delta_TByte op = D->bytecode[D->ip];
-	if (op > OPCODE_LAST)
-		return DELTA_MACHINE_UNKNOWN_OPCODE;
+	size_t					budget			= nInstructions;
+	size_t					ip				= D->ip;
+	delta_SLine*			line			= D->currentLine;
+	size_t					numericHead		= D->numericHead;
+	size_t					stringHead		= D->stringHead;
+	const delta_TByte*		bytecode		= DELTA_MACHINE_BYTECODE(D, line);
+	delta_TNumber* const	numericStack	= D->numericStack;
+	delta_TNumber*			numericValues	= D->numericSlots.values;
+	delta_EStatus			status			= DELTA_OK;
+
+	delta_TNumber*			registerBanks[DELTA_REGISTER_BANK_COUNT] = {
+		[DELTA_REGISTER_VARIABLES]		= D->numericSlots.values,
+		[DELTA_REGISTER_TEMPS]			= D->registerTemps,
+		[DELTA_REGISTER_CONSTANTS]		= D->registerConstants.values,
+		[DELTA_REGISTER_EXEC_CONSTANTS]	= D->execConstants,
+	};
+
+#if (DELTABASIC_MACHINE_PROFILER != 0)
+	const delta_TBool		bProfile		= ((D->flags & DELTA_STATE_PROFILE) != 0);
+	const delta_TBool		bProfileTime	= (bProfile == dtrue) && ((D->flags & DELTA_STATE_PROFILE_TIME) != 0);
+	delta_SProfileTimer		profileTimer	= { NULL, 0, 0 };
+#endif
+
+#if (DELTABASIC_MACHINE_SAMPLER != 0)
+	const delta_TBool		bSample			= ((D->flags & DELTA_STATE_SAMPLE) != 0);
+#endif
+
+#ifdef DELTA_MACHINE_THREADED
+	static const void* const dispatchTable[DELTA_MACHINE_DISPATCH_TABLE_SIZE] = {
+		[0 ... (DELTA_MACHINE_DISPATCH_TABLE_SIZE - 1)] = &&machine_unknown,
+
+		[OPCODE_HLT]		= &&machine_OPCODE_HLT,
+		[OPCODE_NEXTL]		= &&machine_OPCODE_NEXTL,
+		[OPCODE_PUSHS]		= &&machine_OPCODE_PUSHS,
+		[OPCODE_PUSHN]		= &&machine_OPCODE_PUSHN,
+		[OPCODE_CONCAT]		= &&machine_OPCODE_CONCAT,
+		[OPCODE_ADD]		= &&machine_OPCODE_ADD,
+		[OPCODE_SUB]		= &&machine_OPCODE_SUB,
+		[OPCODE_MUL]		= &&machine_OPCODE_MUL,
+		[OPCODE_DIV]		= &&machine_OPCODE_DIV,
+		[OPCODE_MOD]		= &&machine_OPCODE_MOD,
+		[OPCODE_POW]		= &&machine_OPCODE_POW,
+		[OPCODE_SETN]		= &&machine_OPCODE_SETN,
+		[OPCODE_SETS]		= &&machine_OPCODE_SETS,
+		[OPCODE_JMP]		= &&machine_OPCODE_JMP,
+		[OPCODE_PRINTN]		= &&machine_OPCODE_PRINTN,
+		[OPCODE_PRINTNT]	= &&machine_OPCODE_PRINTNT,
+		[OPCODE_PRINTS]		= &&machine_OPCODE_PRINTS,
+		[OPCODE_PRINTST]	= &&machine_OPCODE_PRINTST,
+		[OPCODE_PRINTLN]	= &&machine_OPCODE_PRINTLN,
+		[OPCODE_GETN]		= &&machine_OPCODE_GETN,
+		[OPCODE_GETS]		= &&machine_OPCODE_GETS,
+		[OPCODE_ET]			= &&machine_OPCODE_ET,
+		[OPCODE_NET]		= &&machine_OPCODE_NET,
+		[OPCODE_LT]			= &&machine_OPCODE_LT,
+		[OPCODE_GT]			= &&machine_OPCODE_GT,
+		[OPCODE_LET]		= &&machine_OPCODE_LET,
+		[OPCODE_GET]		= &&machine_OPCODE_GET,
+		[OPCODE_NEG]		= &&machine_OPCODE_NEG,
+		[OPCODE_STOP]		= &&machine_OPCODE_STOP,
+		[OPCODE_RUN]		= &&machine_OPCODE_RUN,
+		[OPCODE_GOSUB]		= &&machine_OPCODE_GOSUB,
+		[OPCODE_RETURN]		= &&machine_OPCODE_RETURN,
+		[OPCODE_JNLNZ]		= &&machine_OPCODE_JNLNZ,
+		[OPCODE_SETFOR]		= &&machine_OPCODE_SETFOR,
+		[OPCODE_SETSTEPFOR]	= &&machine_OPCODE_SETSTEPFOR,
+		[OPCODE_NEXTFOR]	= &&machine_OPCODE_NEXTFOR,
+		[OPCODE_INPUTN]		= &&machine_OPCODE_INPUTN,
+		[OPCODE_INPUTS]		= &&machine_OPCODE_INPUTS,
+		[OPCODE_ALLOCN]		= &&machine_OPCODE_ALLOCN,
+		[OPCODE_ALLOCS]		= &&machine_OPCODE_ALLOCS,
+		[OPCODE_GETIN]		= &&machine_OPCODE_GETIN,
+		[OPCODE_GETIS]		= &&machine_OPCODE_GETIS,
+		[OPCODE_SETIN]		= &&machine_OPCODE_SETIN,
+		[OPCODE_SETIS]		= &&machine_OPCODE_SETIS,
+		[OPCODE_CALL]		= &&machine_OPCODE_CALL,
+		[OPCODE_CALLR]		= &&machine_OPCODE_CALLR,
+		[OPCODE_INCN]		= &&machine_OPCODE_INCN,
+		[OPCODE_SETNC]		= &&machine_OPCODE_SETNC,
+		[OPCODE_JNLNC]		= &&machine_OPCODE_JNLNC,
+		[OPCODE_JNLNN]		= &&machine_OPCODE_JNLNN,
+		[OPCODE_PRINTVN]	= &&machine_OPCODE_PRINTVN,
+		[OPCODE_PRINTVNT]	= &&machine_OPCODE_PRINTVNT,
+		[OPCODE_PRINTVS]	= &&machine_OPCODE_PRINTVS,
+		[OPCODE_PRINTVST]	= &&machine_OPCODE_PRINTVST,
+		[OPCODE_RMOV]		= &&machine_OPCODE_RMOV,
+		[OPCODE_RNEG]		= &&machine_OPCODE_RNEG,
+		[OPCODE_RADD]		= &&machine_OPCODE_RADD,
+		[OPCODE_RSUB]		= &&machine_OPCODE_RSUB,
+		[OPCODE_RMUL]		= &&machine_OPCODE_RMUL,
+		[OPCODE_RDIV]		= &&machine_OPCODE_RDIV,
+		[OPCODE_RMOD]		= &&machine_OPCODE_RMOD,
+		[OPCODE_RPOW]		= &&machine_OPCODE_RPOW,
+		[OPCODE_RET]		= &&machine_OPCODE_RET,
+		[OPCODE_RNET]		= &&machine_OPCODE_RNET,
+		[OPCODE_RLT]		= &&machine_OPCODE_RLT,
+		[OPCODE_RGT]		= &&machine_OPCODE_RGT,
+		[OPCODE_RLET]		= &&machine_OPCODE_RLET,
+		[OPCODE_RGET]		= &&machine_OPCODE_RGET,
+		[OPCODE_RPUSH]		= &&machine_OPCODE_RPUSH,
+		[OPCODE_RJNLZ]		= &&machine_OPCODE_RJNLZ,
+		[OPCODE_CONCATN]	= &&machine_OPCODE_CONCATN,
+		[OPCODE_APPENDS]	= &&machine_OPCODE_APPENDS,
+	};
+
+#if (DELTABASIC_MACHINE_PROFILER != 0)
+	// With `DELTA_STATE_PROFILE` the opcodes are dispatched through `machine_profile`,
+	// so the loop of other states doesn't check the flag
+	static const void* const profileTable[DELTA_MACHINE_DISPATCH_TABLE_SIZE] = {
+		[0 ... (DELTA_MACHINE_DISPATCH_TABLE_SIZE - 1)] = &&machine_unknown,
+		[0 ... (OPCODE_COUNT - 1)] = &&machine_profile,
+	};
+
+	const void* const* const dispatch = (bProfile == dtrue) ? profileTable : dispatchTable;
+#else
+	const void* const* const dispatch = dispatchTable;
+#endif
+
+	DELTA_MACHINE_DISPATCH();
+
+#if (DELTABASIC_MACHINE_PROFILER != 0)
+machine_profile:
+	DELTA_MACHINE_PROFILE();
+	goto *dispatchTable[bytecode[ip]];
+#endif
+#endif
+
+	while (dtrue) {
+#if (DELTABASIC_MACHINE_PROFILER != 0) && !defined(DELTA_MACHINE_THREADED)
+		if ((bProfile == dtrue) && (bytecode[ip] < OPCODE_COUNT))
+			DELTA_MACHINE_PROFILE();
+#endif
+
+		switch (bytecode[ip]) {
+			DELTA_MACHINE_OPCODE(OPCODE_HLT) {
+				line = NULL;
+
+				ip += 1;
+				DELTA_MACHINE_NEXT_LINE();
+			}
 
-	delta_EStatus status = machine_functions[op](D);
-	if (status != DELTA_OK)
-		D->currentLine = NULL;
+			DELTA_MACHINE_OPCODE(OPCODE_NEXTL) {
+				DELTA_MACHINE_SAMPLE();
 
-	return status;
-}
+				DELTA_MACHINE_FALL_THROUGH();
+				DELTA_MACHINE_NEXT_LINE();
+			}
 
-// ******************************************************************************** //
+			DELTA_MACHINE_OPCODE(OPCODE_PUSHS) {
+				if (stringHead + 1 == DELTABASIC_STRING_STACK_SIZE)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_STRING_STACK_OVERFLOW);
 
-/* ****************************************
- * MachineHalt
- */
-delta_EStatus MachineHalt(delta_SState* D) {
-	D->currentLine = NULL;
+				ip += 1;
+				const delta_TWord index = DELTA_MACHINE_WORD(0);
+				const delta_SStringConstants* constants = ((index & DELTA_STRING_CONSTANT_EXEC) != 0) ? &(D->execStringConstants) : &(D->stringConstants);
 
-	D->ip += 1;
-	return DELTA_OK;
-}
+				const delta_UStringValue* str = &(constants->strings[index & DELTA_STRING_CONSTANT_INDEX_MASK]);
+				if (DELTA_STRING_IS_HEAP(str))
+					++(str->heap->refCount);
 
-/* ****************************************
- * MachineNextLine
- */
-delta_EStatus MachineNextLine(delta_SState* D) {
-	D->currentLine = D->currentLine->next;
+				D->stringStack[stringHead++] = *str;
 
-	D->ip += 1;
-	return DELTA_OK;
-}
+				ip += 2;
+				DELTA_MACHINE_NEXT();
+			}
 
-/* ****************************************
- * MachinePushNumeric
- */
-delta_EStatus MachinePushNumeric(delta_SState* D) {
-	if (D->numericHead + 1 == DELTABASIC_NUMERIC_STACK_SIZE)
-		return DELTA_MACHINE_NUMERIC_STACK_OVERFLOW;
+			DELTA_MACHINE_OPCODE(OPCODE_PUSHN) {
+				if (numericHead + 1 == DELTABASIC_NUMERIC_STACK_SIZE)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_OVERFLOW);
 
-	D->ip += 1;
-	const delta_TNumber number = *((delta_TNumber*)(D->bytecode + D->ip));
-	D->numericStack[(D->numericHead)++] = number;
+				ip += 1;
+				numericStack[numericHead++] = DELTA_MACHINE_NUMBER();
 
-	D->ip += 4;
-	return DELTA_OK;
-}
+				ip += 4;
+				DELTA_MACHINE_NEXT();
+			}
 
-/* ****************************************
- * MachineSetNumeric
- */
-delta_EStatus MachineSetNumeric(delta_SState* D) {
-	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
+			DELTA_MACHINE_OPCODE(OPCODE_CONCAT) {
+				DELTA_MACHINE_CALL(MachineConcat);
+				DELTA_MACHINE_NEXT();
+			}
 
-	if (D->numericHead == 0)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
+			DELTA_MACHINE_OPCODE(OPCODE_CONCATN) {
+				const delta_TByte count = bytecode[ip + 1];
 
-	delta_SNumericVariable* var = delta_FindOrAddNumericVariable(D, D->currentLine->str + offset, size);
-	if (var == NULL)
-		return DELTA_ALLOCATOR_ERROR;
+				DELTA_MACHINE_CALL(MachineConcatN);
+				DELTA_MACHINE_CHARGE(count - 1); // As `OPCODE_CONCAT`s
+				DELTA_MACHINE_NEXT();
+			}
 
-	var->value = D->numericStack[--(D->numericHead)];
+			DELTA_MACHINE_OPCODE(OPCODE_APPENDS) {
+				const delta_TByte count = bytecode[ip + 3];
 
-	D->ip += 4;
-	return DELTA_OK;
-}
+				DELTA_MACHINE_CALL(MachineAppendString);
+				DELTA_MACHINE_CHARGE(count); // As `OPCODE_CONCAT`s and `OPCODE_SETS`
+				DELTA_MACHINE_NEXT();
+			}
 
-/* ****************************************
- * MachineGetNumeric
- */
-delta_EStatus MachineGetNumeric(delta_SState* D) {
-	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
+			DELTA_MACHINE_OPCODE(OPCODE_ADD) {
+				if (numericHead < 2)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
 
-	if (D->numericHead + 1 == DELTABASIC_NUMERIC_STACK_SIZE)
-		return DELTA_MACHINE_NUMERIC_STACK_OVERFLOW;
+				--numericHead;
+				numericStack[numericHead - 1] = numericStack[numericHead - 1] + numericStack[numericHead];
 
-	delta_SNumericVariable* var = delta_FindOrAddNumericVariable(D, D->currentLine->str + offset, size);
-	if (var == NULL)
-		return DELTA_ALLOCATOR_ERROR;
+				ip += 1;
+				DELTA_MACHINE_NEXT();
+			}
 
-	D->numericStack[(D->numericHead)++] = var->value;
+			DELTA_MACHINE_OPCODE(OPCODE_SUB) {
+				if (numericHead < 2)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
 
-	D->ip += 4;
-	return DELTA_OK;
-}
+				--numericHead;
+				numericStack[numericHead - 1] = numericStack[numericHead - 1] - numericStack[numericHead];
 
-// ******************************************************************************** //
+				ip += 1;
+				DELTA_MACHINE_NEXT();
+			}
 
-/* ****************************************
- * MachineConcat
- */
-delta_EStatus MachineConcat(delta_SState* D) {
-	if (D->stringHead < 2)
-		return DELTA_MACHINE_STRING_STACK_UNDERFLOW;
+			DELTA_MACHINE_OPCODE(OPCODE_MUL) {
+				if (numericHead < 2)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
 
-	delta_TChar* strA = D->stringStack[D->stringHead - 2];
-	delta_TChar* strB = D->stringStack[D->stringHead - 1];
-	const size_t sizeA = delta_Strlen(strA);
-	const size_t sizeB = delta_Strlen(strB);
-	const size_t size = sizeA + sizeB;
+				--numericHead;
+				numericStack[numericHead - 1] = numericStack[numericHead - 1] * numericStack[numericHead];
 
-	delta_TChar* str = (delta_TChar*)DELTA_Alloc(D, sizeof(delta_TChar) * (size + 1));
-	if (str == NULL)
-		return DELTA_ALLOCATOR_ERROR;
+				ip += 1;
+				DELTA_MACHINE_NEXT();
+			}
 
-	memcpy(str, strA, sizeA);
-	memcpy(str + sizeA, strB, sizeB);
-	str[size] = '\0';
+			DELTA_MACHINE_OPCODE(OPCODE_DIV) {
+				if (numericHead < 2)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
 
-	DELTA_Free(D, strA, sizeof(delta_TChar) * (sizeA + 1));
-	DELTA_Free(D, strB, sizeof(delta_TChar) * (sizeB + 1));
+				--numericHead; // TODO: by zero check?
+				numericStack[numericHead - 1] = numericStack[numericHead - 1] / numericStack[numericHead];
 
-	--(D->stringHead);
-	D->stringStack[D->stringHead - 1] = str;
+				ip += 1;
+				DELTA_MACHINE_NEXT();
+			}
 
-	D->ip += 1;
-	return DELTA_OK;
-}
+			DELTA_MACHINE_OPCODE(OPCODE_MOD) {
+				if (numericHead < 2)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
 
-/* ****************************************
- * MachineAdd
- */
-delta_EStatus MachineAdd(delta_SState* D) {
-	if (D->numericHead < 2)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
+				--numericHead;
+				numericStack[numericHead - 1] = fmodf(numericStack[numericHead - 1], numericStack[numericHead]);
 
-	--(D->numericHead);
-	D->numericStack[D->numericHead - 1] = D->numericStack[D->numericHead - 1] + D->numericStack[D->numericHead];
+				ip += 1;
+				DELTA_MACHINE_NEXT();
+			}
 
-	D->ip += 1;
-	return DELTA_OK;
-}
+			DELTA_MACHINE_OPCODE(OPCODE_POW) {
+				if (numericHead < 2)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
 
-/* ****************************************
- * MachineSub
- */
-delta_EStatus MachineSub(delta_SState* D) {
-	if (D->numericHead < 2)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
+				--numericHead;
+				numericStack[numericHead - 1] = powf(numericStack[numericHead - 1], numericStack[numericHead]);
 
-	--(D->numericHead);
-	D->numericStack[D->numericHead - 1] = D->numericStack[D->numericHead - 1] - D->numericStack[D->numericHead];
+				ip += 1;
+				DELTA_MACHINE_NEXT();
+			}
 
-	D->ip += 1;
-	return DELTA_OK;
-}
+			DELTA_MACHINE_OPCODE(OPCODE_SETN) {
+				ip += 1;
+				const delta_TWord slot = DELTA_MACHINE_WORD(0);
 
-/* ****************************************
- * MachineMul
- */
-delta_EStatus MachineMul(delta_SState* D) {
-	if (D->numericHead < 2)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
+				if (numericHead == 0)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
 
-	--(D->numericHead);
-	D->numericStack[D->numericHead - 1] = D->numericStack[D->numericHead - 1] * D->numericStack[D->numericHead];
+				numericValues[slot] = numericStack[--numericHead];
 
-	D->ip += 1;
-	return DELTA_OK;
-}
+				ip += 2;
+				DELTA_MACHINE_NEXT();
+			}
 
-/* ****************************************
- * MachineDiv
- */
-delta_EStatus MachineDiv(delta_SState* D) {
-	if (D->numericHead < 2)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
+			DELTA_MACHINE_OPCODE(OPCODE_SETS) {
+				DELTA_MACHINE_CALL(MachineSetString);
+				DELTA_MACHINE_NEXT();
+			}
 
-	--(D->numericHead); // TODO: by zero check?
-	D->numericStack[D->numericHead - 1] = D->numericStack[D->numericHead - 1] / D->numericStack[D->numericHead];
+			DELTA_MACHINE_OPCODE(OPCODE_JMP) {
+				DELTA_MACHINE_SAMPLE();
 
-	D->ip += 1;
-	return DELTA_OK;
-}
+				ip += 1;
+				DELTA_MACHINE_JUMP();
+				DELTA_MACHINE_NEXT();
+			}
 
-/* ****************************************
- * MachineMod
- */
-delta_EStatus MachineMod(delta_SState* D) {
-	if (D->numericHead < 2)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
+			DELTA_MACHINE_OPCODE(OPCODE_PRINTN) {
+				DELTA_MACHINE_CALL(MachinePrintNumeric);
+				DELTA_MACHINE_NEXT();
+			}
 
-	--(D->numericHead);
-	D->numericStack[D->numericHead - 1] = fmodf(D->numericStack[D->numericHead - 1], D->numericStack[D->numericHead]);
+			DELTA_MACHINE_OPCODE(OPCODE_PRINTNT) {
+				DELTA_MACHINE_CALL(MachinePrintNumericT);
+				DELTA_MACHINE_NEXT();
+			}
 
-	D->ip += 1;
-	return DELTA_OK;
-}
+			DELTA_MACHINE_OPCODE(OPCODE_PRINTS) {
+				DELTA_MACHINE_CALL(MachinePrintString);
+				DELTA_MACHINE_NEXT();
+			}
 
-/* ****************************************
- * MachinePow
- */
-delta_EStatus MachinePow(delta_SState* D) {
-	if (D->numericHead < 2)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
+			DELTA_MACHINE_OPCODE(OPCODE_PRINTST) {
+				DELTA_MACHINE_CALL(MachinePrintStringT);
+				DELTA_MACHINE_NEXT();
+			}
 
-	--(D->numericHead);
-	D->numericStack[D->numericHead - 1] = powf(D->numericStack[D->numericHead - 1], D->numericStack[D->numericHead]);
+			DELTA_MACHINE_OPCODE(OPCODE_PRINTLN) {
+				DELTA_MACHINE_CALL(MachinePrintNewLine);
+				DELTA_MACHINE_NEXT();
+			}
 
-	D->ip += 1;
-	return DELTA_OK;
-}
+			DELTA_MACHINE_OPCODE(OPCODE_GETN) {
+				ip += 1;
+				const delta_TWord slot = DELTA_MACHINE_WORD(0);
 
-// ******************************************************************************** //
+				if (numericHead + 1 == DELTABASIC_NUMERIC_STACK_SIZE)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_OVERFLOW);
 
-#include <stdio.h>
+				numericStack[numericHead++] = numericValues[slot];
 
-/* ****************************************
- * MachinePrintNumeric
- */
-delta_EStatus MachinePrintNumeric(delta_SState* D) {
-	if (D->numericHead < 1)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
+				ip += 2;
+				DELTA_MACHINE_NEXT();
+			}
 
-	--(D->numericHead);
-	delta_TNumber num = D->numericStack[D->numericHead];
-	delta_TNumber dec = num - (delta_TNumber)((long)num);
-	delta_TChar buffer[32];
+			DELTA_MACHINE_OPCODE(OPCODE_GETS) {
+				DELTA_MACHINE_CALL(MachineGetString);
+				DELTA_MACHINE_NEXT();
+			}
 
-	int size;
-	if (dec < DELTABASIC_NUMERIC_EPSILON)
-		size = snprintf(buffer, 32, "%li", (long)num);
-	else
-		size = snprintf(buffer, 32, "%f", num);
+			DELTA_MACHINE_OPCODE(OPCODE_ET) {
+				if (numericHead < 2)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
 
-	D->printFunction(buffer, size);
+				--numericHead;
+				numericStack[numericHead - 1] =
+					fabsf(numericStack[numericHead - 1] - numericStack[numericHead]) < DELTABASIC_NUMERIC_EPSILON;
 
-	D->ip += 1;
-	return DELTA_OK;
-}
+				ip += 1;
+				DELTA_MACHINE_NEXT();
+			}
 
-/* ****************************************
- * MachinePow
- */
-delta_EStatus MachinePrintNumericT(delta_SState* D) {
-	if (D->numericHead < 1)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
+			DELTA_MACHINE_OPCODE(OPCODE_NET) {
+				if (numericHead < 2)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
 
-	--(D->numericHead);
-	delta_TNumber num = D->numericStack[D->numericHead];
-	delta_TNumber dec = num - (delta_TNumber)((long)num);
-	delta_TChar buffer[32];
+				--numericHead;
+				numericStack[numericHead - 1] =
+					fabsf(numericStack[numericHead - 1] - numericStack[numericHead]) > DELTABASIC_NUMERIC_EPSILON;
 
-	int size;
-	if (dec < DELTABASIC_NUMERIC_EPSILON)
-		size = snprintf(buffer, 32, "%li", (long)num);
-	else
-		size = snprintf(buffer, 32, "%f", num);
+				ip += 1;
+				DELTA_MACHINE_NEXT();
+			}
 
-	D->printFunction(buffer, size);
-	PrintTabs(D, size);
+			DELTA_MACHINE_OPCODE(OPCODE_LT) {
+				if (numericHead < 2)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
 
-	D->ip += 1;
-	return DELTA_OK;
-}
+				--numericHead;
+				numericStack[numericHead - 1] = numericStack[numericHead - 1] < numericStack[numericHead];
 
-/* ****************************************
- * MachinePrintString
- */
-delta_EStatus MachinePrintString(delta_SState* D) {
-	if (D->stringHead < 1)
-		return DELTA_MACHINE_STRING_STACK_UNDERFLOW;
+				ip += 1;
+				DELTA_MACHINE_NEXT();
+			}
 
-	--(D->stringHead);
-	delta_TChar* str = D->stringStack[D->stringHead];
-	size_t size = delta_Strlen(str);
+			DELTA_MACHINE_OPCODE(OPCODE_GT) {
+				if (numericHead < 2)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
 
-	D->printFunction(str, size);
-	DELTA_Free(D, str, sizeof(delta_TChar) * (size + 1));
-	
-	D->ip += 1;
-	return DELTA_OK;
-}
+				--numericHead;
+				numericStack[numericHead - 1] = numericStack[numericHead - 1] > numericStack[numericHead];
 
-/* ****************************************
- * MachinePrintStringT
- */
-delta_EStatus MachinePrintStringT(delta_SState* D) {
-	if (D->stringHead < 1)
-		return DELTA_MACHINE_STRING_STACK_UNDERFLOW;
+				ip += 1;
+				DELTA_MACHINE_NEXT();
+			}
 
-	--(D->stringHead);
-	delta_TChar* str = D->stringStack[D->stringHead];
-	size_t size = delta_Strlen(str);
+			DELTA_MACHINE_OPCODE(OPCODE_LET) {
+				if (numericHead < 2)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
 
-	D->printFunction(str, size);
-	DELTA_Free(D, str, sizeof(delta_TChar) * (size + 1));
+				--numericHead;
+				numericStack[numericHead - 1] = numericStack[numericHead - 1] <= numericStack[numericHead];
 
-	PrintTabs(D, size);
-	
-	D->ip += 1;
+				ip += 1;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_GET) {
+				if (numericHead < 2)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
+
+				--numericHead;
+				numericStack[numericHead - 1] = numericStack[numericHead - 1] >= numericStack[numericHead];
+
+				ip += 1;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_NEG) {
+				if (numericHead < 1)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
+
+				numericStack[numericHead - 1] = -(numericStack[numericHead - 1]);
+
+				ip += 1;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_STOP) {
+				ip += 1;
+				DELTA_MACHINE_ERROR(DELTA_MACHINE_STOP);
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RUN) {
+				DELTA_MACHINE_CHECK_IS_COMPILED();
+
+				line		= D->head;
+				bytecode	= D->bytecode;
+				if (line != NULL)
+					ip = line->offset;
+
+				DELTA_MACHINE_NEXT_LINE();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_GOSUB) {
+				DELTA_MACHINE_SAMPLE();
+
+				if (D->returnHead + 1 == DELTABASIC_RETURN_STACK_SIZE)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_RETURN_STACK_OVERFLOW);
+
+				ip += 1;
+
+				D->returnStack[D->returnHead].ip = ip + 8;
+				D->returnStack[D->returnHead].line = line;
+				++(D->returnHead);
+
+				DELTA_MACHINE_JUMP();
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RETURN) {
+				DELTA_MACHINE_SAMPLE();
+
+				ip += 1;
+
+				if (D->returnHead < 1)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_RETURN_STACK_UNDERFLOW);
+
+				--(D->returnHead);
+				ip			= D->returnStack[D->returnHead].ip;
+				line		= D->returnStack[D->returnHead].line;
+				bytecode	= DELTA_MACHINE_BYTECODE(D, line);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_JNLNZ) {
+				DELTA_MACHINE_SAMPLE();
+
+				ip += 1;
+
+				if (numericHead == 0)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
+
+				const delta_TNumber value = numericStack[--numericHead];
+				if (fabsf(value) < DELTABASIC_NUMERIC_EPSILON)
+					DELTA_MACHINE_FALL_THROUGH();
+
+				DELTA_MACHINE_NEXT_LINE();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_SETFOR) {
+				if (D->forHead + 1 == DELTABASIC_FOR_STACK_SIZE)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_FOR_STACK_OVERFLOW);
+
+				if (numericHead < 2)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
+
+				ip += 1;
+				const delta_TWord slot = DELTA_MACHINE_WORD(0);
+				ip += 2;
+
+				delta_SForState* forState = &(D->forStack[D->forHead]);
+				++(D->forHead);
+
+				forState->startLine = line;
+				forState->startIp = ip;
+				forState->step = 1.0f;
+				forState->end = numericStack[--numericHead];
+
+				numericValues[slot] = numericStack[--numericHead];
+				forState->counter = slot;
+
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_SETSTEPFOR) {
+				if (D->forHead + 1 == DELTABASIC_FOR_STACK_SIZE)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_FOR_STACK_OVERFLOW);
+
+				if (numericHead < 3)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
+
+				ip += 1;
+				const delta_TWord slot = DELTA_MACHINE_WORD(0);
+				ip += 2;
+
+				delta_SForState* forState = &(D->forStack[D->forHead]);
+				++(D->forHead);
+
+				forState->startLine = line;
+				forState->startIp = ip;
+				forState->step = numericStack[--numericHead];
+				forState->end = numericStack[--numericHead];
+
+				numericValues[slot] = numericStack[--numericHead];
+				forState->counter = slot;
+
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_NEXTFOR) {
+				DELTA_MACHINE_SAMPLE();
+
+				if (D->forHead < 1)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_FOR_STACK_UNDERFLOW);
+
+				ip += 1;
+
+				delta_SForState* forState = &(D->forStack[D->forHead - 1]);
+				const delta_TNumber value = (numericValues[forState->counter] += forState->step);
+				const delta_TBool bJump = (forState->step > 0.0f) ?
+					(value <= forState->end) : // Increment
+					(value >= forState->end); // Decrement
+
+				if (bJump == dtrue) {
+					line = forState->startLine;
+					ip = forState->startIp;
+					bytecode = DELTA_MACHINE_BYTECODE(D, line);
+				}
+				else {
+					--(D->forHead);
+				}
+
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_INPUTN) {
+				DELTA_MACHINE_CALL(MachineInputNumeric);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_INPUTS) {
+				DELTA_MACHINE_CALL(MachineInputString);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_ALLOCN) {
+				DELTA_MACHINE_CALL(MachineAllocNumericArray);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_ALLOCS) {
+				DELTA_MACHINE_CALL(MachineAllocStringArray);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_GETIN) {
+				ip += 1;
+				const delta_TWord offset = DELTA_MACHINE_WORD(0);
+				const delta_TWord size   = DELTA_MACHINE_WORD(1);
+
+				if (numericHead == 0)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
+
+				const delta_TNumber index = numericStack[numericHead - 1];
+				if (index < 0.0f)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NEGATIVE_ARGUMENT);
+
+				delta_SNumericArray* array = delta_FindOrAddNumericArray(D, line->str + offset, size);
+				if (array == NULL)
+					DELTA_MACHINE_ERROR(DELTA_ALLOCATOR_ERROR);
+
+				if (array->array == NULL) {
+					array->size = DELTABASIC_ARRAY_MIN_SIZE;
+					status = AllocNumericArray(D, array);
+					if (status != DELTA_OK)
+						goto machine_error;
+				}
+
+				if ((size_t)index >= array->size)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_OUT_OF_RANGE);
+
+				numericStack[numericHead - 1] = array->array[(size_t)index];
+
+				ip += 4;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_GETIS) {
+				DELTA_MACHINE_CALL(MachineGetStringArray);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_SETIN) {
+				ip += 1;
+				const delta_TWord offset = DELTA_MACHINE_WORD(0);
+				const delta_TWord size   = DELTA_MACHINE_WORD(1);
+
+				if (numericHead < 2)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW);
+
+				const delta_TNumber value = numericStack[--numericHead];
+				const delta_TNumber index = numericStack[--numericHead];
+				if (index < 0.0f)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NEGATIVE_ARGUMENT);
+
+				delta_SNumericArray* array = delta_FindOrAddNumericArray(D, line->str + offset, size);
+				if (array == NULL)
+					DELTA_MACHINE_ERROR(DELTA_ALLOCATOR_ERROR);
+
+				if (array->array == NULL) {
+					array->size = DELTABASIC_ARRAY_MIN_SIZE;
+					status = AllocNumericArray(D, array);
+					if (status != DELTA_OK)
+						goto machine_error;
+				}
+
+				if ((size_t)index >= array->size)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_OUT_OF_RANGE);
+
+				array->array[(size_t)index] = value;
+
+				ip += 4;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_SETIS) {
+				DELTA_MACHINE_CALL(MachineSetStringArray);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_CALL) {
+				DELTA_MACHINE_CALL(MachineCall);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_CALLR) {
+				DELTA_MACHINE_CALL(MachineCallReturn);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_INCN) {
+				ip += 1;
+				numericValues[DELTA_MACHINE_WORD(0)] += DELTA_MACHINE_OPERAND(delta_TNumber, 2);
+
+				ip += 6;
+				DELTA_MACHINE_CHARGE(4);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_SETNC) {
+				ip += 1;
+				numericValues[DELTA_MACHINE_WORD(0)] = DELTA_MACHINE_OPERAND(delta_TNumber, 2);
+
+				ip += 6;
+				DELTA_MACHINE_CHARGE(2);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_JNLNC) {
+				DELTA_MACHINE_SAMPLE();
+
+				ip += 1;
+				const delta_TNumber value		= numericValues[DELTA_MACHINE_WORD(0)];
+				const delta_TByte comparison	= DELTA_MACHINE_OPERAND(delta_TByte, 2);
+				const delta_TNumber number		= DELTA_MACHINE_OPERAND(delta_TNumber, 3);
+
+				ip += 7;
+				if (CompareNumbers(comparison, value, number) == dfalse)
+					DELTA_MACHINE_FALL_THROUGH();
+
+				DELTA_MACHINE_CHARGE(4);
+				DELTA_MACHINE_NEXT_LINE();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_JNLNN) {
+				DELTA_MACHINE_SAMPLE();
+
+				ip += 1;
+				const delta_TNumber valueA		= numericValues[DELTA_MACHINE_WORD(0)];
+				const delta_TByte comparison	= DELTA_MACHINE_OPERAND(delta_TByte, 2);
+				const delta_TNumber valueB		= numericValues[DELTA_MACHINE_OPERAND(delta_TWord, 3)];
+
+				ip += 5;
+				if (CompareNumbers(comparison, valueA, valueB) == dfalse)
+					DELTA_MACHINE_FALL_THROUGH();
+
+				DELTA_MACHINE_CHARGE(4);
+				DELTA_MACHINE_NEXT_LINE();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_PRINTVN) {
+				DELTA_MACHINE_CALL(MachinePrintNumericVariable);
+				DELTA_MACHINE_CHARGE(2);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_PRINTVNT) {
+				DELTA_MACHINE_CALL(MachinePrintNumericVariableT);
+				DELTA_MACHINE_CHARGE(2);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_PRINTVS) {
+				DELTA_MACHINE_CALL(MachinePrintStringVariable);
+				DELTA_MACHINE_CHARGE(2);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_PRINTVST) {
+				DELTA_MACHINE_CALL(MachinePrintStringVariableT);
+				DELTA_MACHINE_CHARGE(2);
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RMOV) {
+				ip += 1;
+				DELTA_MACHINE_RWORD(0) = DELTA_MACHINE_RWORD(1);
+
+				ip += 4;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RNEG) {
+				ip += 1;
+				DELTA_MACHINE_RWORD(0) = -(DELTA_MACHINE_RWORD(1));
+
+				ip += 4;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RADD) {
+				ip += 1;
+				DELTA_MACHINE_RWORD(0) = DELTA_MACHINE_RWORD(1) + DELTA_MACHINE_RWORD(2);
+
+				ip += 6;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RSUB) {
+				ip += 1;
+				DELTA_MACHINE_RWORD(0) = DELTA_MACHINE_RWORD(1) - DELTA_MACHINE_RWORD(2);
+
+				ip += 6;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RMUL) {
+				ip += 1;
+				DELTA_MACHINE_RWORD(0) = DELTA_MACHINE_RWORD(1) * DELTA_MACHINE_RWORD(2);
+
+				ip += 6;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RDIV) {
+				ip += 1;
+				DELTA_MACHINE_RWORD(0) = DELTA_MACHINE_RWORD(1) / DELTA_MACHINE_RWORD(2);
+
+				ip += 6;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RMOD) {
+				ip += 1;
+				DELTA_MACHINE_RWORD(0) = fmodf(DELTA_MACHINE_RWORD(1), DELTA_MACHINE_RWORD(2));
+
+				ip += 6;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RPOW) {
+				ip += 1;
+				DELTA_MACHINE_RWORD(0) = powf(DELTA_MACHINE_RWORD(1), DELTA_MACHINE_RWORD(2));
+
+				ip += 6;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RET) {
+				ip += 1;
+				DELTA_MACHINE_RWORD(0) =
+					fabsf(DELTA_MACHINE_RWORD(1) - DELTA_MACHINE_RWORD(2)) < DELTABASIC_NUMERIC_EPSILON;
+
+				ip += 6;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RNET) {
+				ip += 1;
+				DELTA_MACHINE_RWORD(0) =
+					fabsf(DELTA_MACHINE_RWORD(1) - DELTA_MACHINE_RWORD(2)) > DELTABASIC_NUMERIC_EPSILON;
+
+				ip += 6;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RLT) {
+				ip += 1;
+				DELTA_MACHINE_RWORD(0) = DELTA_MACHINE_RWORD(1) < DELTA_MACHINE_RWORD(2);
+
+				ip += 6;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RGT) {
+				ip += 1;
+				DELTA_MACHINE_RWORD(0) = DELTA_MACHINE_RWORD(1) > DELTA_MACHINE_RWORD(2);
+
+				ip += 6;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RLET) {
+				ip += 1;
+				DELTA_MACHINE_RWORD(0) = DELTA_MACHINE_RWORD(1) <= DELTA_MACHINE_RWORD(2);
+
+				ip += 6;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RGET) {
+				ip += 1;
+				DELTA_MACHINE_RWORD(0) = DELTA_MACHINE_RWORD(1) >= DELTA_MACHINE_RWORD(2);
+
+				ip += 6;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RPUSH) {
+				if (numericHead + 1 == DELTABASIC_NUMERIC_STACK_SIZE)
+					DELTA_MACHINE_ERROR(DELTA_MACHINE_NUMERIC_STACK_OVERFLOW);
+
+				ip += 1;
+				numericStack[numericHead++] = DELTA_MACHINE_RWORD(0);
+
+				ip += 2;
+				DELTA_MACHINE_NEXT();
+			}
+
+			DELTA_MACHINE_OPCODE(OPCODE_RJNLZ) {
+				DELTA_MACHINE_SAMPLE();
+
+				ip += 1;
+				const delta_TNumber value = DELTA_MACHINE_RWORD(0);
+
+				ip += 2;
+				if (fabsf(value) < DELTABASIC_NUMERIC_EPSILON) {
+					DELTA_MACHINE_FALL_THROUGH();
+				}
+
+				DELTA_MACHINE_NEXT_LINE();
+			}
+
+			DELTA_MACHINE_OPCODE_DEFAULT() {
+				DELTA_MACHINE_ERROR(DELTA_MACHINE_UNKNOWN_OPCODE);
+			}
+		}
+	}
+
+machine_exit:
+	DELTA_MACHINE_PROFILE_STOP();
+	DELTA_MACHINE_SAVE();
 	return DELTA_OK;
+
+machine_end:
+	DELTA_MACHINE_PROFILE_STOP();
+	DELTA_MACHINE_SAVE();
+	delta_FreeStringStack(D);
+	return DELTA_END;
+
+machine_error:
+	DELTA_MACHINE_SAVE();
+
+machine_failed:
+	DELTA_MACHINE_PROFILE_STOP();
+	D->currentLine = NULL;
+	return status;
 }
 
+#if (DELTABASIC_MACHINE_PROFILER != 0)
 /* ****************************************
- * MachinePrintNewLine
+ * ProfileClock
  */
-delta_EStatus MachinePrintNewLine(delta_SState* D) {
-	delta_TChar buffer[2] = { '\n', '\0' };
-	D->printFunction(buffer, 1);
-	
-	D->ip += 1;
-	return DELTA_OK;
-}
+unsigned long long ProfileClock(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
 
-// ******************************************************************************** //
+	return (unsigned long long)time.tv_sec * 1000000000ull + (unsigned long long)time.tv_nsec;
+}
 
 /* ****************************************
- * MachinePushString
+ * ProfileStart
  */
-delta_EStatus MachinePushString(delta_SState* D) {
-	if (D->stringHead + 1 == DELTABASIC_STRING_STACK_SIZE)
-		return DELTA_MACHINE_STRING_STACK_OVERFLOW;
-
-	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
-	delta_TChar* str = (delta_TChar*)DELTA_Alloc(D, sizeof(delta_TChar) * (size + 1));
-	if (str == NULL)
-		return DELTA_ALLOCATOR_ERROR;
+void ProfileStart(delta_SState* D, delta_SProfileTimer* T, delta_SLine* line, delta_TByte opcode) {
+	const unsigned long long now = ProfileClock();
 
-	memcpy(str, D->currentLine->str + offset, sizeof(delta_TChar) * size);
-	str[size] = '\0';
-
-	D->stringStack[(D->stringHead)++] = str;
+	if (T->line != NULL) {
+		T->line->profile.nanoseconds			+= now - T->start;
+		D->opcodeProfile[T->opcode].nanoseconds	+= now - T->start;
+	}
 
-	D->ip += 4;
-	return DELTA_OK;
+	T->line		= line;
+	T->opcode	= opcode;
+	T->start	= now;
 }
 
 /* ****************************************
- * MachineSetString
+ * ProfileStop
  */
-delta_EStatus MachineSetString(delta_SState* D)  {
-	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
-
-	if (D->stringHead == 0)
-		return DELTA_MACHINE_STRING_STACK_UNDERFLOW;
-
-	delta_SStringVariable* var = delta_FindOrAddStringVariable(D, D->currentLine->str + offset, size);
-	if (var == NULL)
-		return DELTA_ALLOCATOR_ERROR;
+void ProfileStop(delta_SState* D, delta_SProfileTimer* T) {
+	if (T->line == NULL)
+		return;
+
+	const unsigned long long elapsed = ProfileClock() - T->start;
+	T->line->profile.nanoseconds			+= elapsed;
+	D->opcodeProfile[T->opcode].nanoseconds	+= elapsed;
+	T->line = NULL;
+}
+#endif
 
-	if (var->str != NULL) {
-		DELTA_Free(D, var->str, (delta_Strlen(var->str) + 1) * sizeof(delta_TChar));
+#if (DELTABASIC_MACHINE_SAMPLER != 0)
+/* ****************************************
+ * TakeSample
+ */
+delta_EStatus TakeSample(delta_SState* D, const delta_SLine* line) {
+	D->bSampleRequested = 0;
+
+	delta_TChar stack[DELTA_MACHINE_SAMPLE_SIZE];
+	size_t size = 0;
+	for (size_t i = 0; i <= D->returnHead; ++i) {
+		const delta_SLine* frame = (i < D->returnHead) ? D->returnStack[i].line : line;
+		const char* separator = (i < D->returnHead) ? ";" : "";
+
+		if (frame == D->execLine)
+			size += snprintf(stack + size, DELTA_MACHINE_SAMPLE_SIZE - size, "exec%s", separator);
+		else
+			size += snprintf(stack + size, DELTA_MACHINE_SAMPLE_SIZE - size, "%zu%s", frame->line, separator);
 	}
 
-	var->str = D->stringStack[--(D->stringHead)];
+	delta_SSample* sample = delta_FindOrAddSample(D, stack, (uint16_t)size);
+	if (sample == NULL)
+		return DELTA_ALLOCATOR_ERROR;
 
-	D->ip += 4;
+	++(sample->count);
 	return DELTA_OK;
 }
+#endif
 
 /* ****************************************
- * MachineGetString
+ * MachineRecompile
  */
-delta_EStatus MachineGetString(delta_SState* D) {
-	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
-
-	if (D->stringHead + 1 == DELTABASIC_STRING_STACK_SIZE)
-		return DELTA_MACHINE_STRING_STACK_OVERFLOW;
+delta_EStatus MachineRecompile(delta_SState* D, size_t number) {
+	const delta_EStatus status = delta_Compile(D);
+	if (status != DELTA_OK)
+		return status;
 
-	delta_SStringVariable* var = delta_FindOrAddStringVariable(D, D->currentLine->str + offset, size);
-	if (var == NULL)
-		return DELTA_ALLOCATOR_ERROR;
+	size_t index = 0;
+	if (delta_FindJumpTarget(D, number, &index) == dfalse)
+		return DELTA_OUT_OF_LINES_RANGE;
 
-	if (CopyStringToStack(D, var->str) == dfalse)
-		return DELTA_ALLOCATOR_ERROR;
+	D->currentLine	= D->lineVector.array[index];
+	D->ip			= D->currentLine->offset;
 
-	D->ip += 4;
 	return DELTA_OK;
 }
 
 // ******************************************************************************** //
 
 /* ****************************************
- * MachineEqualTo
+ * MachineConcat
  */
-delta_EStatus MachineEqualTo(delta_SState* D) {
-	if (D->numericHead < 2)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
+delta_EStatus MachineConcat(delta_SState* D) {
+	if (D->stringHead < 2)
+		return DELTA_MACHINE_STRING_STACK_UNDERFLOW;
 
-	--(D->numericHead);
-	D->numericStack[D->numericHead - 1] =
-		fabsf(D->numericStack[D->numericHead - 1] - D->numericStack[D->numericHead]) < DELTABASIC_NUMERIC_EPSILON;
+	delta_EStatus status = ConcatStrings(D, 2);
+	if (status != DELTA_OK)
+		return status;
 
 	D->ip += 1;
 	return DELTA_OK;
 }
 
 /* ****************************************
- * MachineNotEqualTo
+ * MachineConcatN
  */
-delta_EStatus MachineNotEqualTo(delta_SState* D) {
-	if (D->numericHead < 2)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
+delta_EStatus MachineConcatN(delta_SState* D) {
+	D->ip += 1;
+	const delta_TByte count = DELTA_MACHINE_BYTECODE(D, D->currentLine)[D->ip];
 
-	--(D->numericHead);
-	D->numericStack[D->numericHead - 1] =
-		fabsf(D->numericStack[D->numericHead - 1] - D->numericStack[D->numericHead]) > DELTABASIC_NUMERIC_EPSILON;
+	if (D->stringHead < count)
+		return DELTA_MACHINE_STRING_STACK_UNDERFLOW;
+
+	delta_EStatus status = ConcatStrings(D, count);
+	if (status != DELTA_OK)
+		return status;
 
 	D->ip += 1;
 	return DELTA_OK;
 }
 
 /* ****************************************
- * MachineLessThan
+ * MachineAppendString
  */
-delta_EStatus MachineLessThan(delta_SState* D) {
-	if (D->numericHead < 2)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
+delta_EStatus MachineAppendString(delta_SState* D) {
+	D->ip += 1;
+	const delta_TWord slot = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
+	const delta_TByte count = DELTA_MACHINE_BYTECODE(D, D->currentLine)[D->ip + 2];
 
-	--(D->numericHead);
-	D->numericStack[D->numericHead - 1] = D->numericStack[D->numericHead - 1] < D->numericStack[D->numericHead];
+	if (D->stringHead < count)
+		return DELTA_MACHINE_STRING_STACK_UNDERFLOW;
 
-	D->ip += 1;
-	return DELTA_OK;
-}
+	delta_UStringValue* value = &(D->stringSlots.values[slot]);
+	delta_UStringValue* first = &(D->stringStack[D->stringHead - count]);
 
-/* ****************************************
- * MachineGreaterThan
- */
-delta_EStatus MachineGreaterThan(delta_SState* D) {
-	if (D->numericHead < 2)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
+	// `S$ = S$ + ...`: move the variable reference to the stack, so that it can be appended in place
+	delta_TBool bAppend = dfalse;
+	if (DELTA_STRING_IS_HEAP(first) && DELTA_STRING_IS_HEAP(value) && (first->heap == value->heap)) {
+		--(first->heap->refCount); // The variable holds one too
+		memset(value, 0x00, sizeof(delta_UStringValue));
+		bAppend = dtrue;
+	}
 
-	--(D->numericHead);
-	D->numericStack[D->numericHead - 1] = D->numericStack[D->numericHead - 1] > D->numericStack[D->numericHead];
+	delta_EStatus status = ConcatStrings(D, count);
+	if (status != DELTA_OK) {
+		if (bAppend == dtrue) {
+			*value = *first;
+			delta_RetainStringValue(value);
+		}
 
-	D->ip += 1;
+		return status;
+	}
+
+	delta_ReleaseStringValue(D, value);
+	*value = D->stringStack[--(D->stringHead)]; // The reference moves from the stack
+
+	D->ip += 3;
 	return DELTA_OK;
 }
 
+// ******************************************************************************** //
+
 /* ****************************************
- * MachineLessOrEqualTo
+ * MachinePrintNumeric
  */
-delta_EStatus MachineLessOrEqualTo(delta_SState* D) {
-	if (D->numericHead < 2)
+delta_EStatus MachinePrintNumeric(delta_SState* D) {
+	if (D->numericHead < 1)
 		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
 
 	--(D->numericHead);
-	D->numericStack[D->numericHead - 1] = D->numericStack[D->numericHead - 1] <= D->numericStack[D->numericHead];
+	PrintNumber(D, D->numericStack[D->numericHead]);
 
 	D->ip += 1;
 	return DELTA_OK;
 }
 
 /* ****************************************
- * MachineGreaterOrEqualTo
+ * MachinePow
  */
-delta_EStatus MachineGreaterOrEqualTo(delta_SState* D) {
-	if (D->numericHead < 2)
+delta_EStatus MachinePrintNumericT(delta_SState* D) {
+	if (D->numericHead < 1)
 		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
 
 	--(D->numericHead);
-	D->numericStack[D->numericHead - 1] = D->numericStack[D->numericHead - 1] >= D->numericStack[D->numericHead];
+	const size_t size = PrintNumber(D, D->numericStack[D->numericHead]);
+	PrintTabs(D, size);
 
 	D->ip += 1;
 	return DELTA_OK;
 }
 
-// ******************************************************************************** //
-
 /* ****************************************
- * MachineNeg
+ * MachinePrintString
  */
-delta_EStatus MachineNeg(delta_SState* D) {
-	if (D->numericHead < 1)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
-	
-	D->numericStack[D->numericHead - 1] = -(D->numericStack[D->numericHead - 1]);
-
-	D->ip += 1;
-	return DELTA_OK;
-}
+delta_EStatus MachinePrintString(delta_SState* D) {
+	if (D->stringHead < 1)
+		return DELTA_MACHINE_STRING_STACK_UNDERFLOW;
 
-// ******************************************************************************** //
+	--(D->stringHead);
+	delta_UStringValue* str = &(D->stringStack[D->stringHead]);
+	size_t size = DELTA_STRING_SIZE(str);
 
-/* ****************************************
- * MachineStop
- */
-delta_EStatus MachineStop(delta_SState* D) {
+	D->printFunction(DELTA_STRING_DATA(str), size);
+	delta_ReleaseStringValue(D, str);
+	
 	D->ip += 1;
-	return DELTA_MACHINE_STOP;
+	return DELTA_OK;
 }
 
 /* ****************************************
- * FindLine
+ * MachinePrintStringT
  */
-delta_SLine* FindLine(delta_SState* D, delta_TWord number) {
-	delta_SLine* line = D->currentLine;
-	if ((D->currentLine->prev == NULL) && (D->currentLine->next == NULL)) {
-		line = D->head;
-
-		if (line == NULL)
-			return NULL;
-	}
+delta_EStatus MachinePrintStringT(delta_SState* D) {
+	if (D->stringHead < 1)
+		return DELTA_MACHINE_STRING_STACK_UNDERFLOW;
 
-	if (line->line == number) {
-		D->ip = line->offset;
-		D->currentLine = line;
-		return line;
-	}
-	else if (line->line > number) {
-		while (line != NULL) {
-			if (line->line == number) {
-				D->ip = line->offset;
-				D->currentLine = line;
-				break;
-			}
+	--(D->stringHead);
+	delta_UStringValue* str = &(D->stringStack[D->stringHead]);
+	size_t size = DELTA_STRING_SIZE(str);
 
-			line = line->prev;
-		}
-	}
-	else { // line->line < number
-		while (line != NULL) {
-			if (line->line == number) {
-				D->ip = line->offset;
-				D->currentLine = line;
-				break;
-			}
+	D->printFunction(DELTA_STRING_DATA(str), size);
+	delta_ReleaseStringValue(D, str);
 
-			line = line->next;
-		}
-	}
+	PrintTabs(D, size);
 	
-	return line;
+	D->ip += 1;
+	return DELTA_OK;
 }
 
 /* ****************************************
- * MachineJump
+ * MachinePrintNewLine
  */
-delta_EStatus MachineJump(delta_SState* D) {
-	D->ip += 1;
-	const delta_TWord number = *((delta_TWord*)(D->bytecode + D->ip));
+delta_EStatus MachinePrintNewLine(delta_SState* D) {
+	delta_TChar buffer[2] = { '\n', '\0' };
+	D->printFunction(buffer, 1);
 	
-	DELTA_MACHINE_CHECK_IS_COMPILED();
-	if (FindLine(D, number) == NULL)
-		return DELTA_OUT_OF_LINES_RANGE;
-
-	//D->ip += 2; // useless
+	D->ip += 1;
 	return DELTA_OK;
 }
 
+// ******************************************************************************** //
+
 /* ****************************************
- * MachineGoSub
+ * MachinePrintNumericVariable
  */
-delta_EStatus MachineGoSub(delta_SState* D) {
-	if (D->returnHead + 1 == DELTABASIC_RETURN_STACK_SIZE)
-		return DELTA_MACHINE_RETURN_STACK_OVERFLOW;
-
+delta_EStatus MachinePrintNumericVariable(delta_SState* D) {
 	D->ip += 1;
-	const delta_TWord number = *((delta_TWord*)(D->bytecode + D->ip));
-	D->ip += 2;
-	
-	D->returnStack[D->returnHead].ip = D->ip;
-	D->returnStack[D->returnHead].line = D->currentLine;
+	const delta_TWord slot = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
 
-	DELTA_MACHINE_CHECK_IS_COMPILED();
-	if (FindLine(D, number) == NULL)
-		return DELTA_OUT_OF_LINES_RANGE;
-
-	++(D->returnHead);
+	PrintNumber(D, D->numericSlots.values[slot]);
 
+	D->ip += 2;
 	return DELTA_OK;
 }
 
 /* ****************************************
- * MachineReturn
+ * MachinePrintNumericVariableT
  */
-delta_EStatus MachineReturn(delta_SState* D) {
+delta_EStatus MachinePrintNumericVariableT(delta_SState* D) {
 	D->ip += 1;
+	const delta_TWord slot = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
 
-	if (D->returnHead < 1)
-		return DELTA_MACHINE_RETURN_STACK_UNDERFLOW;
-
-	--(D->returnHead);
-	D->ip			= D->returnStack[D->returnHead].ip;
-	D->currentLine	= D->returnStack[D->returnHead].line;
+	const size_t size = PrintNumber(D, D->numericSlots.values[slot]);
+	PrintTabs(D, size);
 
+	D->ip += 2;
 	return DELTA_OK;
 }
 
 /* ****************************************
- * MachineJumpNextLineIfNotZero
+ * MachinePrintStringVariable
  */
-delta_EStatus MachineJumpNextLineIfNotZero(delta_SState* D) {
+delta_EStatus MachinePrintStringVariable(delta_SState* D) {
 	D->ip += 1;
+	const delta_TWord slot = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
 
-	if (D->numericHead == 0)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
-
-	--(D->numericHead);
-	delta_TNumber value = D->numericStack[D->numericHead];
-	if (fabsf(value) < DELTABASIC_NUMERIC_EPSILON) {
-		D->currentLine = D->currentLine->next;
-		if (D->currentLine != NULL)
-			D->ip = D->currentLine->offset;
-	}
+	const delta_UStringValue* str = &(D->stringSlots.values[slot]);
+	D->printFunction(DELTA_STRING_DATA(str), DELTA_STRING_SIZE(str));
 
+	D->ip += 2;
 	return DELTA_OK;
 }
 
-// ******************************************************************************** //
-
 /* ****************************************
- * MachineSetFor
+ * MachinePrintStringVariableT
  */
-delta_EStatus MachineSetFor(delta_SState* D) {
-	if (D->forHead + 1 == DELTABASIC_FOR_STACK_SIZE)
-		return DELTA_MACHINE_FOR_STACK_OVERFLOW;
-
-	if (D->numericHead < 2)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
-
+delta_EStatus MachinePrintStringVariableT(delta_SState* D) {
 	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
-
-	delta_SNumericVariable* var = delta_FindOrAddNumericVariable(D, D->currentLine->str + offset, size);
-	if (var == NULL)
-		return DELTA_ALLOCATOR_ERROR;
-
-	D->ip += 4;
-
-	delta_SForState* forState = &(D->forStack[D->forHead]);
-	++(D->forHead);
+	const delta_TWord slot = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
 
-	forState->startLine = D->currentLine;
-	forState->startIp = D->ip;
-	forState->step = 1.0f;
-
-	--(D->numericHead);
-	forState->end = D->numericStack[D->numericHead];
+	const delta_UStringValue* str = &(D->stringSlots.values[slot]);
+	const size_t size = DELTA_STRING_SIZE(str);
+	D->printFunction(DELTA_STRING_DATA(str), size);
+	PrintTabs(D, size);
 
-	--(D->numericHead);
-	var->value = D->numericStack[D->numericHead];
-	forState->counter = var;
-	
+	D->ip += 2;
 	return DELTA_OK;
 }
 
+// ******************************************************************************** //
+
 /* ****************************************
- * MachineSetStepFor
+ * MachineSetString
  */
-delta_EStatus MachineSetStepFor(delta_SState* D) {
-	if (D->forHead + 1 == DELTABASIC_FOR_STACK_SIZE)
-		return DELTA_MACHINE_FOR_STACK_OVERFLOW;
-
-	if (D->numericHead < 2)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
-
+delta_EStatus MachineSetString(delta_SState* D)  {
 	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
-
-	if (D->numericHead < 3)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
-
-	delta_SNumericVariable* var = delta_FindOrAddNumericVariable(D, D->currentLine->str + offset, size);
-	if (var == NULL)
-		return DELTA_ALLOCATOR_ERROR;
-
-	D->ip += 4;
-
-	delta_SForState* forState = &(D->forStack[D->forHead]);
-	++(D->forHead);
+	const delta_TWord slot = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
 
-	forState->startLine = D->currentLine;
-	forState->startIp = D->ip;
+	if (D->stringHead == 0)
+		return DELTA_MACHINE_STRING_STACK_UNDERFLOW;
 
-	--(D->numericHead);
-	forState->step = D->numericStack[D->numericHead];
+	delta_UStringValue* value = &(D->stringSlots.values[slot]);
+	delta_ReleaseStringValue(D, value);
 
-	--(D->numericHead);
-	forState->end = D->numericStack[D->numericHead];
+	*value = D->stringStack[--(D->stringHead)]; // The reference moves from the stack
 
-	--(D->numericHead);
-	var->value = D->numericStack[D->numericHead];
-	forState->counter = var;
-	
+	D->ip += 2;
 	return DELTA_OK;
 }
 
 /* ****************************************
- * MachineNextFor
+ * MachineGetString
  */
-delta_EStatus MachineNextFor(delta_SState* D) {
-	if (D->forHead < 1)
-		return DELTA_MACHINE_FOR_STACK_UNDERFLOW;
-
+delta_EStatus MachineGetString(delta_SState* D) {
 	D->ip += 1;
+	const delta_TWord slot = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
 
-	delta_SForState* forState = &(D->forStack[D->forHead - 1]);
-	if (forState->counter == NULL) // Just in case
-		return DELTA_ALLOCATOR_ERROR;
-
-	forState->counter->value += forState->step;
-	const delta_TBool bJump = (forState->step > 0.0f) ?
-		(forState->counter->value <= forState->end) : // Increment
-		(forState->counter->value >= forState->end); // Decrement
+	if (D->stringHead + 1 == DELTABASIC_STRING_STACK_SIZE)
+		return DELTA_MACHINE_STRING_STACK_OVERFLOW;
 
-	if (bJump == dtrue) {
-		D->currentLine = forState->startLine;
-		D->ip = forState->startIp;
-	}
-	else {
-		--(D->forHead);
-	}
+	PushStringToStack(D, &(D->stringSlots.values[slot]));
 
+	D->ip += 2;
 	return DELTA_OK;
 }
 
@@ -934,10 +1553,11 @@ delta_EStatus MachineNextFor(delta_SState* D) {
  */
 delta_EStatus MachineInputNumeric(delta_SState* D) {
 	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
+	const delta_TWord slot = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
 	
-	D->printFunction(D->currentLine->str + offset, size);
+	const delta_TChar* name = D->numericSlots.variables[slot]->name;
+
+	D->printFunction(name, delta_Strlen(name));
 	D->printFunction("? ", 2);
 
 	delta_TChar buffer[DELTABASIC_INPUT_BUFFER_SIZE];
@@ -950,13 +1570,9 @@ delta_EStatus MachineInputNumeric(delta_SState* D) {
 	if (delta_ReadInteger(buffer, &value) == NULL)
 		return DELTA_MACHINE_INPUT_PARSE_ERROR;
 
-	delta_SNumericVariable* var = delta_FindOrAddNumericVariable(D, D->currentLine->str + offset, size);
-	if (var == NULL)
-		return DELTA_ALLOCATOR_ERROR;
-
-	var->value = value;
+	D->numericSlots.values[slot] = value;
 
-	D->ip += 4;
+	D->ip += 2;
 	return DELTA_OK;
 }
 
@@ -965,10 +1581,11 @@ delta_EStatus MachineInputNumeric(delta_SState* D) {
  */
 delta_EStatus MachineInputString(delta_SState* D) {
 	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
+	const delta_TWord slot = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
 
-	D->printFunction(D->currentLine->str + offset, size);
+	const delta_TChar* name = D->stringSlots.variables[slot]->name;
+
+	D->printFunction(name, delta_Strlen(name));
 	D->printFunction("$? ", 3);
 
 	delta_TChar buffer[DELTABASIC_INPUT_BUFFER_SIZE];
@@ -976,24 +1593,13 @@ delta_EStatus MachineInputString(delta_SState* D) {
 	if (inputSize < 1)
 		return DELTA_MACHINE_NOT_ENOUGH_INPUT_DATA;
 
-	delta_SStringVariable* var = delta_FindOrAddStringVariable(D, D->currentLine->str + offset, size);
-	if (var == NULL)
-		return DELTA_ALLOCATOR_ERROR;
-
-	if (var->str != NULL) {
-		DELTA_Free(D, var->str, (delta_Strlen(var->str) + 1) * sizeof(delta_TChar));
-	}
+	delta_UStringValue* value = &(D->stringSlots.values[slot]);
+	delta_ReleaseStringValue(D, value);
 
-	delta_TChar* str = (delta_TChar*)DELTA_Alloc(D, sizeof(delta_TChar) * (inputSize + 1));
-	if (str == NULL)
+	if (delta_CreateStringValue(D, value, buffer, inputSize) == dfalse)
 		return DELTA_ALLOCATOR_ERROR;
 
-	memcpy(str, buffer, sizeof(delta_TChar) * inputSize);
-	str[inputSize] = '\0';
-
-	var->str = str;
-
-	D->ip += 4;
+	D->ip += 2;
 	return DELTA_OK;
 }
 
@@ -1003,7 +1609,7 @@ delta_EStatus MachineInputString(delta_SState* D) {
  * AllocNumericArray
  */
 delta_EStatus AllocNumericArray(delta_SState* D, delta_SNumericArray* array) {
-	array->array = (delta_TNumber*)DELTA_Alloc(D, sizeof(delta_TNumber) * (array->size));
+	array->array = (delta_TNumber*)DELTA_Alloc(D, DELTA_MEMORY_ARRAYS, sizeof(delta_TNumber) * (array->size));
 	if (array->array == NULL)
 		return DELTA_ALLOCATOR_ERROR;
 
@@ -1017,17 +1623,11 @@ delta_EStatus AllocNumericArray(delta_SState* D, delta_SNumericArray* array) {
  * AllocStringArray
  */
 delta_EStatus AllocStringArray(delta_SState* D, delta_SStringArray* array) {
-	array->array = (delta_TChar**)DELTA_Alloc(D, sizeof(delta_TChar*) * (array->size));
+	array->array = (delta_UStringValue*)DELTA_Alloc(D, DELTA_MEMORY_ARRAYS, sizeof(delta_UStringValue) * (array->size));
 	if (array->array == NULL)
 		return DELTA_ALLOCATOR_ERROR;
 
-	for (size_t i = 0; i < array->size; ++i) {
-		array->array[i] = (delta_TChar*)DELTA_Alloc(D, sizeof(delta_TChar) * 2);
-		if (array->array[i] == NULL)
-			return DELTA_ALLOCATOR_ERROR;
-
-		array->array[i][0] = '\0';
-	}
+	memset(array->array, 0x00, sizeof(delta_UStringValue) * (array->size)); // Empty strings
 
 	return DELTA_OK;
 }
@@ -1039,8 +1639,8 @@ delta_EStatus AllocStringArray(delta_SState* D, delta_SStringArray* array) {
  */
 delta_EStatus MachineAllocNumericArray(delta_SState* D) {
 	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
+	const delta_TWord offset = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
+	const delta_TWord size   = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[1];
 
 	if (D->numericHead == 0)
 		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
@@ -1070,8 +1670,8 @@ delta_EStatus MachineAllocNumericArray(delta_SState* D) {
  */
 delta_EStatus MachineAllocStringArray(delta_SState* D) {
 	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
+	const delta_TWord offset = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
+	const delta_TWord size   = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[1];
 
 	if (D->numericHead == 0)
 		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
@@ -1098,48 +1698,13 @@ delta_EStatus MachineAllocStringArray(delta_SState* D) {
 
 // ******************************************************************************** //
 
-/* ****************************************
- * MachineGetNumericArray
- */
-delta_EStatus MachineGetNumericArray(delta_SState* D) {
-	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
-
-	if (D->numericHead == 0)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
-
-	delta_TNumber index = D->numericStack[(D->numericHead) - 1];
-	if (index < 0.0f)
-		return DELTA_MACHINE_NEGATIVE_ARGUMENT;
-
-	delta_SNumericArray* array = delta_FindOrAddNumericArray(D, D->currentLine->str + offset, size);
-	if (array == NULL)
-		return DELTA_ALLOCATOR_ERROR;
-
-	if (array->array == NULL) {
-		array->size = DELTABASIC_ARRAY_MIN_SIZE;
-		delta_EStatus status = AllocNumericArray(D, array);
-		if (status != DELTA_OK)
-			return status;
-	}
-
-	if ((size_t)index >= array->size)
-		return DELTA_MACHINE_OUT_OF_RANGE;
-
-	D->numericStack[(D->numericHead) - 1] = array->array[(size_t)index];
-	
-	D->ip += 4;
-	return DELTA_OK;
-}
-
 /* ****************************************
  * MachineGetStringArray
  */
 delta_EStatus MachineGetStringArray(delta_SState* D) {
 	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
+	const delta_TWord offset = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
+	const delta_TWord size   = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[1];
 
 	if (D->numericHead == 0)
 		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
@@ -1165,11 +1730,7 @@ delta_EStatus MachineGetStringArray(delta_SState* D) {
 	if ((size_t)index >= array->size)
 		return DELTA_MACHINE_OUT_OF_RANGE;
 
-	if (array->array[(size_t)index] == NULL) // Just check
-		return DELTA_ALLOCATOR_ERROR;
-
-	if (CopyStringToStack(D, array->array[(size_t)index]) == dfalse)
-		return DELTA_ALLOCATOR_ERROR;
+	PushStringToStack(D, &(array->array[(size_t)index]));
 	
 	D->ip += 4;
 	return DELTA_OK;
@@ -1177,49 +1738,13 @@ delta_EStatus MachineGetStringArray(delta_SState* D) {
 
 // ******************************************************************************** //
 
-/* ****************************************
- * MachineSetNumericArray
- */
-delta_EStatus MachineSetNumericArray(delta_SState* D) {
-	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
-
-	if (D->numericHead < 2)
-		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
-
-	delta_TNumber value = D->numericStack[--(D->numericHead)];
-	delta_TNumber index = D->numericStack[--(D->numericHead)];
-	if (index < 0.0f)
-		return DELTA_MACHINE_NEGATIVE_ARGUMENT;
-
-	delta_SNumericArray* array = delta_FindOrAddNumericArray(D, D->currentLine->str + offset, size);
-	if (array == NULL)
-		return DELTA_ALLOCATOR_ERROR;
-
-	if (array->array == NULL) {
-		array->size = DELTABASIC_ARRAY_MIN_SIZE;
-		delta_EStatus status = AllocNumericArray(D, array);
-		if (status != DELTA_OK)
-			return status;
-	}
-
-	if ((size_t)index >= array->size)
-		return DELTA_MACHINE_OUT_OF_RANGE;
-
-	array->array[(size_t)index] = value;
-
-	D->ip += 4;
-	return DELTA_OK;
-}
-
 /* ****************************************
  * MachineSetStringArray
  */
 delta_EStatus MachineSetStringArray(delta_SState* D) {
 	D->ip += 1;
-	const delta_TWord offset = ((delta_TWord*)(D->bytecode + D->ip))[0];
-	const delta_TWord size   = ((delta_TWord*)(D->bytecode + D->ip))[1];
+	const delta_TWord offset = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
+	const delta_TWord size   = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[1];
 
 	if (D->numericHead < 1)
 		return DELTA_MACHINE_NUMERIC_STACK_UNDERFLOW;
@@ -1245,10 +1770,7 @@ delta_EStatus MachineSetStringArray(delta_SState* D) {
 	if ((size_t)index >= array->size)
 		return DELTA_MACHINE_OUT_OF_RANGE;
 
-	if (array->array[(size_t)index] != NULL) {
-		DELTA_Free(D, array->array[(size_t)index], (delta_Strlen(array->array[(size_t)index]) + 1) * sizeof(delta_TChar));
-	}
-
+	delta_ReleaseStringValue(D, &(array->array[(size_t)index]));
 	array->array[(size_t)index] = D->stringStack[--(D->stringHead)];
 
 	D->ip += 4;
@@ -1268,7 +1790,8 @@ delta_EStatus CallCFunction(delta_SState* D, size_t index) {
 				return DELTA_MACHINE_STRING_STACK_UNDERFLOW;
 
 			--(D->stringHead);
-			D->cfuncArgs[i].string = D->stringStack[D->stringHead];
+			D->cfuncStrings[i] = D->stringStack[D->stringHead];
+			D->cfuncArgs[i].string = DELTA_STRING_DATA(&(D->cfuncStrings[i]));
 		}
 		else {
 			if (D->numericHead < 1)
@@ -1284,7 +1807,7 @@ delta_EStatus CallCFunction(delta_SState* D, size_t index) {
 	D->currentCFunc = NULL;
 	for (delta_TByte i = 0; i < func->argCount; ++i) {
 		if (((func->argsMask >> i) & 0x01) == DELTA_CFUNC_ARG_STRING) {
-			DELTA_Free(D, (delta_TChar*)(D->cfuncArgs[i].string), sizeof(delta_TChar) * (delta_Strlen(D->cfuncArgs[i].string) + 1));
+			delta_ReleaseStringValue(D, &(D->cfuncStrings[i]));
 		}
 	}
 	
@@ -1300,7 +1823,8 @@ delta_EStatus CallCFunction(delta_SState* D, size_t index) {
 			if (D->stringHead + 1 == DELTABASIC_STRING_STACK_SIZE)
 				return DELTA_MACHINE_STRING_STACK_OVERFLOW;
 
-			D->stringStack[D->stringHead] = (delta_TChar*)D->cfuncReturn.string;
+			D->stringStack[D->stringHead] = D->cfuncReturnString; // Empty if the function didn't return
+			memset(&(D->cfuncReturnString), 0x00, sizeof(delta_UStringValue));
 			++(D->stringHead);
 		}
 	}
@@ -1313,7 +1837,7 @@ delta_EStatus CallCFunction(delta_SState* D, size_t index) {
  */
 delta_EStatus MachineCall(delta_SState* D) {
 	D->ip += 1;
-	const delta_TWord index = ((delta_TWord*)(D->bytecode + D->ip))[0];
+	const delta_TWord index = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
 
 	D->bIgnoreCFuncReturn = dtrue;
 
@@ -1330,10 +1854,10 @@ delta_EStatus MachineCall(delta_SState* D) {
  */
 delta_EStatus MachineCallReturn(delta_SState* D) {
 	D->ip += 1;
-	const delta_TWord index = ((delta_TWord*)(D->bytecode + D->ip))[0];
+	const delta_TWord index = ((delta_TWord*)(DELTA_MACHINE_BYTECODE(D, D->currentLine) + D->ip))[0];
 
 	D->bIgnoreCFuncReturn = dfalse;
-	D->cfuncReturn.string = NULL;
+	delta_ReleaseStringValue(D, &(D->cfuncReturnString));
 
 	delta_EStatus status = CallCFunction(D, index);
 	if (status != DELTA_OK)
@@ -1345,20 +1869,6 @@ delta_EStatus MachineCallReturn(delta_SState* D) {
 
 // ******************************************************************************** //
 
-/* ****************************************
- * MachineRun
- */
-delta_EStatus MachineRun(delta_SState* D) {
-	DELTA_MACHINE_CHECK_IS_COMPILED();
-	
-	D->ip			= DELTABASIC_EXEC_BYTECODE_SIZE;
-	D->currentLine	= D->head;
-
-	return DELTA_OK;
-}
-
-// ******************************************************************************** //
-
 /* ****************************************
  * FormatNumeric
  */
@@ -1413,23 +1923,71 @@ size_t PrintTabs(delta_SState* D, size_t size) {
 }
 
 /* ****************************************
- * CopyStringToStack
+ * PrintNumber
  */
-inline delta_TBool CopyStringToStack(delta_SState *D, delta_TChar str[]) {
-	size_t strSize = 0;
-	if (str)
-		strSize = delta_Strlen(str);
-	
-	delta_TChar* tmp = (delta_TChar*)DELTA_Alloc(D, sizeof(delta_TChar) * (strSize + 1));
-	if (tmp == NULL)
-		return dfalse;
+size_t PrintNumber(delta_SState* D, delta_TNumber number) {
+	delta_TNumber dec = number - (delta_TNumber)((long)number);
+	delta_TChar buffer[32];
 
-	if (str)
-		memcpy(tmp, str, sizeof(delta_TChar) * strSize);
-		
-	tmp[strSize] = '\0';
+	int size;
+	if (dec < DELTABASIC_NUMERIC_EPSILON)
+		size = snprintf(buffer, 32, "%li", (long)number);
+	else
+		size = snprintf(buffer, 32, "%f", number);
+
+	D->printFunction(buffer, size);
+	return (size_t)size;
+}
+
+/* ****************************************
+ * CompareNumbers
+ */
+inline delta_TBool CompareNumbers(delta_TByte comparison, delta_TNumber a, delta_TNumber b) {
+	switch (comparison) {
+		case OPCODE_ET:		return fabsf(a - b) < DELTABASIC_NUMERIC_EPSILON;
+		case OPCODE_NET:	return fabsf(a - b) > DELTABASIC_NUMERIC_EPSILON;
+		case OPCODE_LT:		return a < b;
+		case OPCODE_GT:		return a > b;
+		case OPCODE_LET:	return a <= b;
+		case OPCODE_GET:	return a >= b;
+	}
+
+	return dfalse;
+}
+
+/* ****************************************
+ * ConcatStrings
+ */
+delta_EStatus ConcatStrings(delta_SState* D, size_t count) {
+	delta_UStringValue* strings = &(D->stringStack[D->stringHead - count]);
+
+	size_t size = 0;
+	for (size_t i = 0; i < count; ++i)
+		size += DELTA_STRING_SIZE(&(strings[i]));
+
+	// Grows the first string in place if the stack holds its only reference
+	size_t offset = DELTA_STRING_SIZE(&(strings[0]));
+	if (delta_ResizeStringValue(D, &(strings[0]), size) == dfalse)
+		return DELTA_ALLOCATOR_ERROR;
+
+	delta_TChar* str = DELTA_STRING_DATA(&(strings[0]));
+	for (size_t i = 1; i < count; ++i) {
+		const size_t strSize = DELTA_STRING_SIZE(&(strings[i]));
+		memcpy(str + offset, DELTA_STRING_DATA(&(strings[i])), sizeof(delta_TChar) * strSize);
+		offset += strSize;
+
+		delta_ReleaseStringValue(D, &(strings[i]));
+	}
 
-	D->stringStack[(D->stringHead)++] = tmp;
+	D->stringHead -= count - 1;
+	return DELTA_OK;
+}
 
-	return dtrue;
+/* ****************************************
+ * PushStringToStack
+ */
+inline void PushStringToStack(delta_SState *D, const delta_UStringValue* str) {
+	delta_RetainStringValue(str);
+	D->stringStack[D->stringHead] = *str;
+	++(D->stringHead);
 }
@@ -13,8 +13,10 @@
 // ******************************************************************************** //
 
 /**
- * delta_ExecuteInstruction
+ * Execute up to `nInstructions` instructions in one go
+ *
+ * \note `nInstructions` must not be zero
  */
-delta_EStatus		delta_ExecuteInstruction(delta_SState* D);
+delta_EStatus		delta_ExecuteInstructions(delta_SState* D, size_t nInstructions);
 
 #endif /* !__DELTABASIC_MACHINE_H__ */
@@ -9,6 +9,11 @@
 #include <stdlib.h>
 
 #include "dlimits.h"
+#include "dstate.h"
+#include "deltabasic_config.h"
+
+#define DELTA_ARENA_ALIGNMENT								(2 * sizeof(void*))
+#define DELTA_ARENA_ALIGN(size)								(((size) + DELTA_ARENA_ALIGNMENT - 1) & ~(DELTA_ARENA_ALIGNMENT - 1))
 
 // ******************************************************************************** //
 
@@ -28,4 +33,103 @@ void* delta_Allocator(void* ptr, size_t currentSize, size_t newSize, void* userD
 		return malloc(newSize);
 	
 	return realloc(ptr, newSize);
-}
\ No newline at end of file
+}
+
+/* ****************************************
+ * CountSizeClass
+ */
+static void CountSizeClass(delta_SMemoryStats* stats, size_t size) {
+	size_t class = 0;
+	while ((class + 1 < DELTABASIC_MEMORY_SIZE_CLASSES) && (size > ((size_t)16 << class)))
+		++class;
+
+	++(stats->sizeClasses[class]);
+}
+
+/* ****************************************
+ * delta_CountedAlloc
+ */
+void* delta_CountedAlloc(delta_SState* D, delta_EMemoryCategory category, void* ptr, size_t size, size_t newSize) {
+	void* result = D->allocFunction(ptr, size, newSize, D->allocFuncUserData);
+
+	delta_SMemoryStats* stats[2] = { &(D->memoryStats[category]), &(D->memoryStats[DELTA_MEMORY_TOTAL]) };
+	for (size_t i = 0; i < 2; ++i) {
+		delta_SMemoryStats* s = stats[i];
+
+		if ((newSize == 0) || (result == NULL)) { // Freed, or a failed reallocation that freed `ptr`
+			if (size != 0) {
+				s->liveBytes -= size;
+				++(s->frees);
+			}
+
+			continue;
+		}
+
+		s->liveBytes += newSize - size;
+		s->peakBytes = DELTABASIC_MAX(s->peakBytes, s->liveBytes);
+
+		if (size == 0)
+			++(s->allocations);
+		else
+			++(s->reallocations);
+
+		CountSizeClass(s, newSize);
+	}
+
+	return result;
+}
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * delta_ArenaAlloc
+ */
+void* delta_ArenaAlloc(delta_SState* D, size_t size) {
+	size = DELTA_ARENA_ALIGN(size);
+
+	delta_SArena* arena = &(D->arena);
+	delta_SArenaChunk* chunk = arena->head;
+	if ((chunk == NULL) || (chunk->size - chunk->used < size)) {
+		const size_t chunkSize = DELTABASIC_MAX(size, DELTABASIC_ARENA_CHUNK_SIZE);
+		const size_t blockSize = DELTA_ARENA_ALIGN(sizeof(delta_SArenaChunk)) + chunkSize;
+
+		delta_SArenaChunk* newChunk = (delta_SArenaChunk*)DELTA_Alloc(D, DELTA_MEMORY_ARENA, blockSize);
+		if (newChunk == NULL)
+			return NULL;
+
+		newChunk->size	= chunkSize;
+		newChunk->used	= 0;
+
+		if ((chunk != NULL) && (chunk->size - chunk->used > chunkSize - size)) { // Oversized, keep filling the current chunk
+			newChunk->next	= chunk->next;
+			chunk->next		= newChunk;
+		}
+		else {
+			newChunk->next	= chunk;
+			arena->head		= newChunk;
+		}
+
+		chunk = newChunk;
+	}
+
+	void* ptr = ((delta_TByte*)chunk) + DELTA_ARENA_ALIGN(sizeof(delta_SArenaChunk)) + chunk->used;
+	chunk->used += size;
+
+	return ptr;
+}
+
+/* ****************************************
+ * delta_ReleaseArena
+ */
+void delta_ReleaseArena(delta_SState* D) {
+	delta_SArenaChunk* chunk = D->arena.head;
+	while (chunk != NULL) {
+		delta_SArenaChunk* next = chunk->next;
+
+		DELTA_Free(D, DELTA_MEMORY_ARENA, chunk, DELTA_ARENA_ALIGN(sizeof(delta_SArenaChunk)) + chunk->size);
+
+		chunk = next;
+	}
+
+	D->arena.head = NULL;
+}
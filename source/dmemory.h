@@ -11,9 +11,39 @@
 
 #include "deltabasic.h"
 
-#define DELTA_Alloc(D, size)								((D)->allocFunction(NULL,		0,	(size),		(D)->allocFuncUserData))
-#define DELTA_Realloc(D, ptr, size, newsize)				((D)->allocFunction((ptr),	(size),	(newsize),	(D)->allocFuncUserData))
-#define DELTA_Free(D, ptr, size)							((D)->allocFunction((ptr),	(size),	0,			(D)->allocFuncUserData))
+/**
+ * `category` is a `delta_EMemoryCategory`, counted with `DELTA_STATE_MEMORY_STATS`
+ */
+#define DELTA_AllocCall(D, category, ptr, size, newsize)	((((D)->flags & DELTA_STATE_MEMORY_STATS) != 0) ? delta_CountedAlloc((D), (category), (ptr), (size), (newsize)) : (D)->allocFunction((ptr), (size), (newsize), (D)->allocFuncUserData))
+
+#define DELTA_Alloc(D, category, size)						DELTA_AllocCall((D), (category), NULL,	0,		(size))
+#define DELTA_Realloc(D, category, ptr, size, newsize)		DELTA_AllocCall((D), (category), (ptr),	(size),	(newsize))
+#define DELTA_Free(D, category, ptr, size)					DELTA_AllocCall((D), (category), (ptr),	(size),	0)
+
+/**
+ * Long-lived objects (lines, variables, arrays). Bump-allocated from `D->arena` with `DELTA_STATE_ARENA`,
+ * where freeing one is a no-op and everything is released at once by `delta_ReleaseArena`
+ */
+#define DELTA_ArenaAlloc(D, category, size)					((((D)->flags & DELTA_STATE_ARENA) != 0) ? delta_ArenaAlloc((D), (size)) : DELTA_Alloc((D), (category), (size)))
+#define DELTA_ArenaFree(D, category, ptr, size)				{ if (((D)->flags & DELTA_STATE_ARENA) == 0) DELTA_Free((D), (category), (ptr), (size)); }
+
+// ******************************************************************************** //
+
+/**
+ * delta_SArenaChunk
+ */
+typedef struct delta_SArenaChunk {
+	struct delta_SArenaChunk*	next;
+	size_t						size; // Of the data, allocated at the end of the struct
+	size_t						used;
+} delta_SArenaChunk;
+
+/**
+ * delta_SArena
+ */
+typedef struct delta_SArena {
+	delta_SArenaChunk*			head; // Current chunk
+} delta_SArena;
 
 // ******************************************************************************** //
 
@@ -22,4 +52,21 @@
  */
 void*				delta_Allocator(void* ptr, size_t currentSize, size_t newSize, void* userData);
 
+/**
+ * `D->allocFunction` call counted in `D->memoryStats`
+ */
+void*				delta_CountedAlloc(delta_SState* D, delta_EMemoryCategory category, void* ptr, size_t size, size_t newSize);
+
+/**
+ * Allocate `size` bytes from the current chunk of `D->arena`, or from a new one
+ *
+ * \return `NULL` on allocation failure
+ */
+void*				delta_ArenaAlloc(delta_SState* D, size_t size);
+
+/**
+ * Free every chunk of `D->arena`
+ */
+void				delta_ReleaseArena(delta_SState* D);
+
 #endif /* !__DELTABASIC_MEMORY_H__ */
@@ -0,0 +1,181 @@
+/**
+ * \file	dopcodes.c
+ * \brief	VM opcodes
+ * \date	17 oct 2026
+ * \author	Reklov
+ */
+#include "dopcodes.h"
+
+// ******************************************************************************** //
+
+static const delta_TByte opcode_sizes[OPCODE_COUNT] = {
+	[OPCODE_HLT]		= 1,
+	[OPCODE_NEXTL]		= 1,
+	[OPCODE_PUSHS]		= 1 + 2,
+	[OPCODE_PUSHN]		= 1 + 4,
+	[OPCODE_CONCAT]		= 1,
+	[OPCODE_ADD]		= 1,
+	[OPCODE_SUB]		= 1,
+	[OPCODE_MUL]		= 1,
+	[OPCODE_DIV]		= 1,
+	[OPCODE_MOD]		= 1,
+	[OPCODE_POW]		= 1,
+	[OPCODE_SETN]		= 1 + 2,
+	[OPCODE_SETS]		= 1 + 2,
+	[OPCODE_JMP]		= 1 + 4 + 4,
+	[OPCODE_PRINTN]		= 1,
+	[OPCODE_PRINTNT]	= 1,
+	[OPCODE_PRINTS]		= 1,
+	[OPCODE_PRINTST]	= 1,
+	[OPCODE_PRINTLN]	= 1,
+	[OPCODE_GETN]		= 1 + 2,
+	[OPCODE_GETS]		= 1 + 2,
+	[OPCODE_ET]			= 1,
+	[OPCODE_NET]		= 1,
+	[OPCODE_LT]			= 1,
+	[OPCODE_GT]			= 1,
+	[OPCODE_LET]		= 1,
+	[OPCODE_GET]		= 1,
+	[OPCODE_NEG]		= 1,
+	[OPCODE_STOP]		= 1,
+	[OPCODE_RUN]		= 1,
+	[OPCODE_GOSUB]		= 1 + 4 + 4,
+	[OPCODE_RETURN]		= 1,
+	[OPCODE_JNLNZ]		= 1,
+	[OPCODE_SETFOR]		= 1 + 2,
+	[OPCODE_SETSTEPFOR]	= 1 + 2,
+	[OPCODE_NEXTFOR]	= 1,
+	[OPCODE_INPUTN]		= 1 + 2,
+	[OPCODE_INPUTS]		= 1 + 2,
+	[OPCODE_ALLOCN]		= 1 + 2 + 2,
+	[OPCODE_ALLOCS]		= 1 + 2 + 2,
+	[OPCODE_GETIN]		= 1 + 2 + 2,
+	[OPCODE_GETIS]		= 1 + 2 + 2,
+	[OPCODE_SETIN]		= 1 + 2 + 2,
+	[OPCODE_SETIS]		= 1 + 2 + 2,
+	[OPCODE_CALL]		= 1 + 2,
+	[OPCODE_CALLR]		= 1 + 2,
+	[OPCODE_INCN]		= 1 + 2 + 4,
+	[OPCODE_SETNC]		= 1 + 2 + 4,
+	[OPCODE_JNLNC]		= 1 + 2 + 1 + 4,
+	[OPCODE_JNLNN]		= 1 + 2 + 1 + 2,
+	[OPCODE_PRINTVN]	= 1 + 2,
+	[OPCODE_PRINTVNT]	= 1 + 2,
+	[OPCODE_PRINTVS]	= 1 + 2,
+	[OPCODE_PRINTVST]	= 1 + 2,
+	[OPCODE_RMOV]		= 1 + 2 + 2,
+	[OPCODE_RNEG]		= 1 + 2 + 2,
+	[OPCODE_RADD]		= 1 + 2 + 2 + 2,
+	[OPCODE_RSUB]		= 1 + 2 + 2 + 2,
+	[OPCODE_RMUL]		= 1 + 2 + 2 + 2,
+	[OPCODE_RDIV]		= 1 + 2 + 2 + 2,
+	[OPCODE_RMOD]		= 1 + 2 + 2 + 2,
+	[OPCODE_RPOW]		= 1 + 2 + 2 + 2,
+	[OPCODE_RET]		= 1 + 2 + 2 + 2,
+	[OPCODE_RNET]		= 1 + 2 + 2 + 2,
+	[OPCODE_RLT]		= 1 + 2 + 2 + 2,
+	[OPCODE_RGT]		= 1 + 2 + 2 + 2,
+	[OPCODE_RLET]		= 1 + 2 + 2 + 2,
+	[OPCODE_RGET]		= 1 + 2 + 2 + 2,
+	[OPCODE_RPUSH]		= 1 + 2,
+	[OPCODE_RJNLZ]		= 1 + 2,
+	[OPCODE_CONCATN]	= 1 + 1,
+	[OPCODE_APPENDS]	= 1 + 2 + 1,
+};
+
+static const char* const opcode_names[OPCODE_COUNT] = {
+	[OPCODE_HLT]		= "HLT",
+	[OPCODE_NEXTL]		= "NEXTL",
+	[OPCODE_PUSHS]		= "PUSHS",
+	[OPCODE_PUSHN]		= "PUSHN",
+	[OPCODE_CONCAT]		= "CONCAT",
+	[OPCODE_ADD]		= "ADD",
+	[OPCODE_SUB]		= "SUB",
+	[OPCODE_MUL]		= "MUL",
+	[OPCODE_DIV]		= "DIV",
+	[OPCODE_MOD]		= "MOD",
+	[OPCODE_POW]		= "POW",
+	[OPCODE_SETN]		= "SETN",
+	[OPCODE_SETS]		= "SETS",
+	[OPCODE_JMP]		= "JMP",
+	[OPCODE_PRINTN]		= "PRINTN",
+	[OPCODE_PRINTNT]	= "PRINTNT",
+	[OPCODE_PRINTS]		= "PRINTS",
+	[OPCODE_PRINTST]	= "PRINTST",
+	[OPCODE_PRINTLN]	= "PRINTLN",
+	[OPCODE_GETN]		= "GETN",
+	[OPCODE_GETS]		= "GETS",
+	[OPCODE_ET]			= "ET",
+	[OPCODE_NET]		= "NET",
+	[OPCODE_LT]			= "LT",
+	[OPCODE_GT]			= "GT",
+	[OPCODE_LET]		= "LET",
+	[OPCODE_GET]		= "GET",
+	[OPCODE_NEG]		= "NEG",
+	[OPCODE_STOP]		= "STOP",
+	[OPCODE_RUN]		= "RUN",
+	[OPCODE_GOSUB]		= "GOSUB",
+	[OPCODE_RETURN]		= "RETURN",
+	[OPCODE_JNLNZ]		= "JNLNZ",
+	[OPCODE_SETFOR]		= "SETFOR",
+	[OPCODE_SETSTEPFOR]	= "SETSTEPFOR",
+	[OPCODE_NEXTFOR]	= "NEXTFOR",
+	[OPCODE_INPUTN]		= "INPUTN",
+	[OPCODE_INPUTS]		= "INPUTS",
+	[OPCODE_ALLOCN]		= "ALLOCN",
+	[OPCODE_ALLOCS]		= "ALLOCS",
+	[OPCODE_GETIN]		= "GETIN",
+	[OPCODE_GETIS]		= "GETIS",
+	[OPCODE_SETIN]		= "SETIN",
+	[OPCODE_SETIS]		= "SETIS",
+	[OPCODE_CALL]		= "CALL",
+	[OPCODE_CALLR]		= "CALLR",
+	[OPCODE_INCN]		= "INCN",
+	[OPCODE_SETNC]		= "SETNC",
+	[OPCODE_JNLNC]		= "JNLNC",
+	[OPCODE_JNLNN]		= "JNLNN",
+	[OPCODE_PRINTVN]	= "PRINTVN",
+	[OPCODE_PRINTVNT]	= "PRINTVNT",
+	[OPCODE_PRINTVS]	= "PRINTVS",
+	[OPCODE_PRINTVST]	= "PRINTVST",
+	[OPCODE_RMOV]		= "RMOV",
+	[OPCODE_RNEG]		= "RNEG",
+	[OPCODE_RADD]		= "RADD",
+	[OPCODE_RSUB]		= "RSUB",
+	[OPCODE_RMUL]		= "RMUL",
+	[OPCODE_RDIV]		= "RDIV",
+	[OPCODE_RMOD]		= "RMOD",
+	[OPCODE_RPOW]		= "RPOW",
+	[OPCODE_RET]		= "RET",
+	[OPCODE_RNET]		= "RNET",
+	[OPCODE_RLT]		= "RLT",
+	[OPCODE_RGT]		= "RGT",
+	[OPCODE_RLET]		= "RLET",
+	[OPCODE_RGET]		= "RGET",
+	[OPCODE_RPUSH]		= "RPUSH",
+	[OPCODE_RJNLZ]		= "RJNLZ",
+	[OPCODE_CONCATN]	= "CONCATN",
+	[OPCODE_APPENDS]	= "APPENDS",
+};
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * delta_GetOpcodeSize
+ */
+size_t delta_GetOpcodeSize(delta_TByte opcode) {
+	if (opcode >= OPCODE_COUNT)
+		return 0;
+
+	return opcode_sizes[opcode];
+}
+
+/* ****************************************
+ * delta_GetOpcodeName
+ */
+const char* delta_GetOpcodeName(delta_TByte opcode) {
+	if (opcode >= OPCODE_COUNT)
+		return NULL;
+
+	return opcode_names[opcode];
+}
@@ -7,6 +7,10 @@
 #ifndef __DELTABASIC_OPCODES_H__
 #define __DELTABASIC_OPCODES_H__
 
+#include <stddef.h>
+
+#include "dlimits.h"
+
 // ******************************************************************************** //
 
 /**
@@ -15,7 +19,7 @@
 typedef enum {
 	OPCODE_HLT,		// Halt
 	OPCODE_NEXTL,	// Next line
-	OPCODE_PUSHS,	// 1 (offset)
+	OPCODE_PUSHS,	// 2 (string constant index, see `DELTA_STRING_CONSTANT_EXEC`)
 	OPCODE_PUSHN,	// 4 (Number)
 	OPCODE_CONCAT,
 	OPCODE_ADD,
@@ -24,16 +28,16 @@ typedef enum {
 	OPCODE_DIV,
 	OPCODE_MOD,
 	OPCODE_POW,
-	OPCODE_SETN,	// Set Numeric Varialbe 2, 2 (offset, size)
-	OPCODE_SETS,	// Set String Varialbe  2, 2 (offset, size)
-	OPCODE_JMP,		// 4 (line)
+	OPCODE_SETN,	// Set Numeric Varialbe 2 (slot)
+	OPCODE_SETS,	// Set String Varialbe  2 (slot)
+	OPCODE_JMP,		// 4 (line number) 4 (line index), see `delta_Link`
 	OPCODE_PRINTN,	// Print Numeric
 	OPCODE_PRINTNT, // Print Numeric with Tabs
 	OPCODE_PRINTS,
 	OPCODE_PRINTST,
 	OPCODE_PRINTLN, // Print New Line
-	OPCODE_GETN,
-	OPCODE_GETS,
+	OPCODE_GETN,	// 2 (slot)
+	OPCODE_GETS,	// 2 (slot)
 	OPCODE_ET,		// Equal To
 	OPCODE_NET,		// Not Equal To
 	OPCODE_LT,		// Less Than
@@ -43,14 +47,14 @@ typedef enum {
 	OPCODE_NEG,		//
 	OPCODE_STOP,
 	OPCODE_RUN,
-	OPCODE_GOSUB,
+	OPCODE_GOSUB,	// 4 (line number) 4 (line index), see `delta_Link`
 	OPCODE_RETURN,
 	OPCODE_JNLNZ,		// Jump to next line if not zero
-	OPCODE_SETFOR,		// for VARNAME=CONST to CONST
-	OPCODE_SETSTEPFOR,	// for VARNAME=CONST to CONST step CONST
+	OPCODE_SETFOR,		// for VARNAME=CONST to CONST; 2 (slot)
+	OPCODE_SETSTEPFOR,	// for VARNAME=CONST to CONST step CONST; 2 (slot)
 	OPCODE_NEXTFOR,
-	OPCODE_INPUTN,		// Input Numeric
-	OPCODE_INPUTS,		// Input String
+	OPCODE_INPUTN,		// Input Numeric; 2 (slot)
+	OPCODE_INPUTS,		// Input String; 2 (slot)
 	OPCODE_ALLOCN,		// Allocate Number Array
 	OPCODE_ALLOCS,		// Allocate String Array
 	OPCODE_GETIN,		// Get indexed Number
@@ -59,8 +63,75 @@ typedef enum {
 	OPCODE_SETIS,		// Set indexed String
 	OPCODE_CALL,		// Call cfunc
 	OPCODE_CALLR,		// Call with return
+
+	// Superinstructions, see `delta_Optimize`
+	OPCODE_INCN,		// Increment Numeric Variable; 2 (slot) 4 (Number)
+	OPCODE_SETNC,		// Set Numeric Variable to a constant; 2 (slot) 4 (Number)
+	OPCODE_JNLNC,		// Jump to next line if the comparison of a Numeric Variable with a constant is false; 2 (slot) 1 (comparison opcode) 4 (Number)
+	OPCODE_JNLNN,		// Jump to next line if the comparison of two Numeric Variables is false; 2 (slot) 1 (comparison opcode) 2 (slot)
+	OPCODE_PRINTVN,		// Print Numeric Variable; 2 (slot)
+	OPCODE_PRINTVNT,	// Print Numeric Variable with Tabs; 2 (slot)
+	OPCODE_PRINTVS,		// Print String Variable; 2 (slot)
+	OPCODE_PRINTVST,	// Print String Variable with Tabs; 2 (slot)
+
+	// Register tier, see `delta_TranslateRegisters`. Operands are `DELTA_REGISTER_*` words
+	OPCODE_RMOV,		// 2 (dst) 2 (a)
+	OPCODE_RNEG,		// 2 (dst) 2 (a)
+	OPCODE_RADD,		// 2 (dst) 2 (a) 2 (b), same order as `OPCODE_ADD` to `OPCODE_POW`
+	OPCODE_RSUB,
+	OPCODE_RMUL,
+	OPCODE_RDIV,
+	OPCODE_RMOD,
+	OPCODE_RPOW,
+	OPCODE_RET,			// 2 (dst) 2 (a) 2 (b), same order as `OPCODE_ET` to `OPCODE_GET`
+	OPCODE_RNET,
+	OPCODE_RLT,
+	OPCODE_RGT,
+	OPCODE_RLET,
+	OPCODE_RGET,
+	OPCODE_RPUSH,		// Push register on the numeric stack; 2 (a)
+	OPCODE_RJNLZ,		// Jump to next line if register is zero; 2 (a)
+
+	OPCODE_CONCATN,		// Concatenate the top strings of the stack at once; 1 (count)
+	OPCODE_APPENDS,		// Concatenate the top strings into a variable, in place if the first one is its value; 2 (slot) 1 (count)
 	OPCODE_COUNT,
-	OPCODE_LAST = OPCODE_CALLR,
+	OPCODE_LAST = OPCODE_APPENDS,
 } delta_EOpcodes;
 
+/**
+ * Register operand: bank in the high bits, index in the bank in the low bits
+ */
+#define DELTA_REGISTER_BANK_SHIFT			14
+#define DELTA_REGISTER_INDEX_MASK			0x3FFF
+
+#define DELTA_REGISTER_VARIABLES			0 // `D->numericSlots.values`
+#define DELTA_REGISTER_TEMPS				1 // `D->registerTemps`
+#define DELTA_REGISTER_CONSTANTS			2 // `D->registerConstants.values`
+#define DELTA_REGISTER_EXEC_CONSTANTS		3 // `D->execConstants`
+#define DELTA_REGISTER_BANK_COUNT			4
+
+#define DELTA_REGISTER(bank, index)			((delta_TWord)(((bank) << DELTA_REGISTER_BANK_SHIFT) | (index)))
+
+/**
+ * `OPCODE_PUSHS` operand: index in `D->stringConstants`, or in `D->execStringConstants` with this bit
+ */
+#define DELTA_STRING_CONSTANT_EXEC			0x8000
+#define DELTA_STRING_CONSTANT_INDEX_MASK	0x7FFF
+
+// ******************************************************************************** //
+
+/**
+ * Size of the instruction in bytes, operands included
+ *
+ * \return 0 for unknown opcodes
+ */
+size_t				delta_GetOpcodeSize(delta_TByte opcode);
+
+/**
+ * Name of the opcode without its `OPCODE_` prefix, see `delta_Disassemble`
+ *
+ * \return NULL for unknown opcodes
+ */
+const char*			delta_GetOpcodeName(delta_TByte opcode);
+
 #endif /* !__DELTABASIC_OPCODES_H__ */
@@ -0,0 +1,357 @@
+/**
+ * \file	dregister.c
+ * \brief	Register tier of the VM
+ * \date	17 oct 2026
+ * \author	Reklov
+ */
+#include "dregister.h"
+
+#include <string.h>
+
+#include "dmemory.h"
+#include "dopcodes.h"
+
+#define DELTA_REGISTER_MAX_GROWTH							7 // `OPCODE_RADD` for a single `OPCODE_ADD` byte
+
+// ******************************************************************************** //
+
+/**
+ * delta_SRegisterTranslator
+ */
+typedef struct delta_SRegisterTranslator {
+	delta_SState*	D;
+	delta_TBool		bExec;
+
+	delta_TByte*	out;
+	size_t			index;
+
+	delta_TWord		stack[DELTABASIC_NUMERIC_STACK_SIZE]; // Operands that are not on the numeric stack yet
+	size_t			head;
+
+	size_t			lastEnd; // `index` after the last instruction that wrote a temporary
+	size_t			lastDst; // Offset of its destination operand
+} delta_SRegisterTranslator;
+
+// ******************************************************************************** //
+
+/**
+ * EmitByte
+ */
+static void			EmitByte(delta_SRegisterTranslator* T, delta_TByte byte);
+
+/**
+ * EmitWord
+ */
+static void			EmitWord(delta_SRegisterTranslator* T, delta_TWord word);
+
+/**
+ * Push every pending operand on the numeric stack, bottom first
+ */
+static void			Flush(delta_SRegisterTranslator* T);
+
+/**
+ * Constant operand for `number`
+ *
+ * \return `dfalse` if the constant pool is full
+ */
+static delta_TBool	AddConstant(delta_SRegisterTranslator* T, delta_TNumber number, delta_TWord* operand);
+
+/**
+ * Temporaries are allocated as a stack, so the next free one is their count on the pending stack
+ */
+static size_t		CountTemps(const delta_SRegisterTranslator* T);
+
+/**
+ * ReferencesOperand
+ */
+static delta_TBool	ReferencesOperand(const delta_SRegisterTranslator* T, delta_TWord operand);
+
+/**
+ * Translate a single instruction
+ *
+ * \return `dfalse` if the instruction must be kept as is
+ */
+static delta_TBool	TranslateInstruction(delta_SRegisterTranslator* T, const delta_TByte* in);
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * delta_TranslateRegisters
+ */
+delta_EStatus delta_TranslateRegisters(delta_SState* D, delta_SBytecode* BC, size_t begin, delta_TBool bExec) {
+	const size_t end = BC->index;
+	if (end <= begin)
+		return DELTA_OK;
+
+	if (bExec == dtrue)
+		D->execConstantsSize = 0;
+
+	delta_SRegisterTranslator T = { 0 };
+	T.D			= D;
+	T.bExec		= bExec;
+	T.lastEnd	= SIZE_MAX;
+
+	const size_t outSize = (end - begin) * DELTA_REGISTER_MAX_GROWTH;
+	T.out = (delta_TByte*)DELTA_Alloc(D, DELTA_MEMORY_BYTECODE, sizeof(delta_TByte) * outSize);
+	if (T.out == NULL)
+		return DELTA_ALLOCATOR_ERROR;
+
+	size_t ip = begin;
+	while (ip < end) {
+		const delta_TByte* in = BC->bytecode + ip;
+		const size_t size = delta_GetOpcodeSize(in[0]);
+		if (size == 0) {
+			DELTA_Free(D, DELTA_MEMORY_BYTECODE, T.out, sizeof(delta_TByte) * outSize);
+			return DELTA_MACHINE_UNKNOWN_OPCODE;
+		}
+
+		if (TranslateInstruction(&T, in) == dfalse) {
+			Flush(&T);
+
+			memcpy(T.out + T.index, in, size);
+			T.index += size;
+		}
+
+		ip += size;
+	}
+
+	Flush(&T);
+
+	delta_EStatus status = DELTA_OK;
+	while (begin + T.index > BC->bytecodeSize) {
+		if (BC->bCanResize == dfalse) // Exec line, keep the stack code
+			break;
+
+		if (delta_ExpandBytecode(D, BC) == dfalse) {
+			status = DELTA_ALLOCATOR_ERROR;
+			break;
+		}
+	}
+
+	if ((status == DELTA_OK) && (begin + T.index <= BC->bytecodeSize)) {
+		memcpy(BC->bytecode + begin, T.out, T.index);
+		BC->index = begin + T.index;
+	}
+
+	DELTA_Free(D, DELTA_MEMORY_BYTECODE, T.out, sizeof(delta_TByte) * outSize);
+	return status;
+}
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * EmitByte
+ */
+inline void EmitByte(delta_SRegisterTranslator* T, delta_TByte byte) {
+	T->out[T->index] = byte;
+	T->index += 1;
+}
+
+/* ****************************************
+ * EmitWord
+ */
+inline void EmitWord(delta_SRegisterTranslator* T, delta_TWord word) {
+	*((delta_TWord*)(T->out + T->index)) = word;
+	T->index += 2;
+}
+
+/* ****************************************
+ * Flush
+ */
+void Flush(delta_SRegisterTranslator* T) {
+	for (size_t i = 0; i < T->head; ++i) {
+		EmitByte(T, OPCODE_RPUSH);
+		EmitWord(T, T->stack[i]);
+	}
+
+	T->head = 0;
+}
+
+/* ****************************************
+ * AddConstant
+ */
+delta_TBool AddConstant(delta_SRegisterTranslator* T, delta_TNumber number, delta_TWord* operand) {
+	delta_SState* D = T->D;
+
+	if (T->bExec == dtrue) {
+		if (D->execConstantsSize == sizeof(D->execConstants) / sizeof(D->execConstants[0]))
+			return dfalse;
+
+		*operand = DELTA_REGISTER(DELTA_REGISTER_EXEC_CONSTANTS, D->execConstantsSize);
+		D->execConstants[D->execConstantsSize++] = number;
+
+		return dtrue;
+	}
+
+	delta_SRegisterConstants* pool = &(D->registerConstants);
+	if (pool->size > DELTA_REGISTER_INDEX_MASK)
+		return dfalse;
+
+	if (pool->size == pool->allocated) {
+		const size_t newSize = (pool->allocated == 0) ? DELTABASIC_REGISTER_CONSTANTS_START_SIZE : pool->allocated * 2;
+
+		delta_TNumber* values = (delta_TNumber*)DELTA_Realloc(D, DELTA_MEMORY_BYTECODE, pool->values, sizeof(delta_TNumber) * pool->allocated, sizeof(delta_TNumber) * newSize);
+		if (values == NULL)
+			return dfalse;
+
+		pool->values	= values;
+		pool->allocated	= newSize;
+	}
+
+	*operand = DELTA_REGISTER(DELTA_REGISTER_CONSTANTS, pool->size);
+	pool->values[pool->size++] = number;
+
+	return dtrue;
+}
+
+/* ****************************************
+ * CountTemps
+ */
+size_t CountTemps(const delta_SRegisterTranslator* T) {
+	size_t count = 0;
+	for (size_t i = 0; i < T->head; ++i) {
+		if ((T->stack[i] >> DELTA_REGISTER_BANK_SHIFT) == DELTA_REGISTER_TEMPS)
+			++count;
+	}
+
+	return count;
+}
+
+/* ****************************************
+ * ReferencesOperand
+ */
+delta_TBool ReferencesOperand(const delta_SRegisterTranslator* T, delta_TWord operand) {
+	for (size_t i = 0; i < T->head; ++i) {
+		if (T->stack[i] == operand)
+			return dtrue;
+	}
+
+	return dfalse;
+}
+
+/* ****************************************
+ * TranslateInstruction
+ */
+delta_TBool TranslateInstruction(delta_SRegisterTranslator* T, const delta_TByte* in) {
+	const delta_TByte opcode = in[0];
+
+	switch (opcode) {
+		case OPCODE_PUSHN: {
+			if (T->head == DELTABASIC_NUMERIC_STACK_SIZE)
+				return dfalse;
+
+			delta_TWord operand = 0;
+			if (AddConstant(T, *((delta_TNumber*)(in + 1)), &operand) == dfalse)
+				return dfalse;
+
+			T->stack[T->head++] = operand;
+			return dtrue;
+		}
+
+		case OPCODE_GETN: {
+			const delta_TWord slot = *((delta_TWord*)(in + 1));
+			if ((T->head == DELTABASIC_NUMERIC_STACK_SIZE) || (slot > DELTA_REGISTER_INDEX_MASK))
+				return dfalse;
+
+			T->stack[T->head++] = DELTA_REGISTER(DELTA_REGISTER_VARIABLES, slot);
+			return dtrue;
+		}
+
+		case OPCODE_ADD: case OPCODE_SUB: case OPCODE_MUL: case OPCODE_DIV: case OPCODE_MOD: case OPCODE_POW:
+		case OPCODE_ET: case OPCODE_NET: case OPCODE_LT: case OPCODE_GT: case OPCODE_LET: case OPCODE_GET: {
+			if (T->head < 2)
+				return dfalse;
+
+			const delta_TWord a = T->stack[T->head - 2];
+			const delta_TWord b = T->stack[T->head - 1];
+
+			T->head -= 2;
+			const size_t temp = CountTemps(T);
+			if (temp >= DELTABASIC_MACHINE_REGISTER_TEMPS) {
+				T->head += 2;
+				return dfalse;
+			}
+
+			const delta_TWord dst = DELTA_REGISTER(DELTA_REGISTER_TEMPS, temp);
+			if (opcode <= OPCODE_POW)
+				EmitByte(T, OPCODE_RADD + (opcode - OPCODE_ADD));
+			else
+				EmitByte(T, OPCODE_RET + (opcode - OPCODE_ET));
+
+			T->lastDst = T->index;
+			EmitWord(T, dst);
+			EmitWord(T, a);
+			EmitWord(T, b);
+			T->lastEnd = T->index;
+
+			T->stack[T->head++] = dst;
+			return dtrue;
+		}
+
+		case OPCODE_NEG: {
+			if (T->head < 1)
+				return dfalse;
+
+			const delta_TWord a = T->stack[T->head - 1];
+
+			T->head -= 1;
+			const size_t temp = CountTemps(T);
+			if (temp >= DELTABASIC_MACHINE_REGISTER_TEMPS) {
+				T->head += 1;
+				return dfalse;
+			}
+
+			const delta_TWord dst = DELTA_REGISTER(DELTA_REGISTER_TEMPS, temp);
+			EmitByte(T, OPCODE_RNEG);
+			T->lastDst = T->index;
+			EmitWord(T, dst);
+			EmitWord(T, a);
+			T->lastEnd = T->index;
+
+			T->stack[T->head++] = dst;
+			return dtrue;
+		}
+
+		case OPCODE_SETN: {
+			const delta_TWord slot = *((delta_TWord*)(in + 1));
+			if ((T->head < 1) || (slot > DELTA_REGISTER_INDEX_MASK))
+				return dfalse;
+
+			const delta_TWord variable = DELTA_REGISTER(DELTA_REGISTER_VARIABLES, slot);
+			const delta_TWord value = T->stack[T->head - 1];
+
+			T->head -= 1;
+			if (ReferencesOperand(T, variable) == dtrue) { // A pending read of the variable must see the old value
+				T->head += 1;
+				return dfalse;
+			}
+
+			// The value was just computed into a temporary, compute it into the variable instead
+			if ((T->lastEnd == T->index) && (*((delta_TWord*)(T->out + T->lastDst)) == value) &&
+				((value >> DELTA_REGISTER_BANK_SHIFT) == DELTA_REGISTER_TEMPS)) {
+				*((delta_TWord*)(T->out + T->lastDst)) = variable;
+			}
+			else {
+				EmitByte(T, OPCODE_RMOV);
+				EmitWord(T, variable);
+				EmitWord(T, value);
+			}
+
+			T->lastEnd = SIZE_MAX;
+			return dtrue;
+		}
+
+		case OPCODE_JNLNZ: {
+			if (T->head != 1)
+				return dfalse;
+
+			EmitByte(T, OPCODE_RJNLZ);
+			EmitWord(T, T->stack[0]);
+
+			T->head = 0;
+			return dtrue;
+		}
+	}
+
+	return dfalse;
+}
@@ -0,0 +1,27 @@
+/**
+ * \file	dregister.h
+ * \brief	Register tier of the VM
+ * \date	17 oct 2026
+ * \author	Reklov
+ */
+#ifndef __DELTABASIC_REGISTER_H__
+#define __DELTABASIC_REGISTER_H__
+
+#include "deltabasic.h"
+#include "dstate.h"
+#include "dlimits.h"
+#include "dcompiler.h"
+
+// ******************************************************************************** //
+
+/**
+ * Rewrite the numeric stack code of one line in [`begin`; `BC->index`) into three-address
+ * instructions over variable slots, temporaries and constants, see `OPCODE_RMOV`.
+ * Anything the register tier doesn't cover is kept as is, after its operands were pushed
+ * on the numeric stack. The stack code is kept if the result doesn't fit in `BC`.
+ *
+ * `bExec` puts the constants in `D->execConstants` instead of the program pool
+ */
+delta_EStatus		delta_TranslateRegisters(delta_SState* D, delta_SBytecode* BC, size_t begin, delta_TBool bExec);
+
+#endif /* !__DELTABASIC_REGISTER_H__ */
@@ -11,10 +11,61 @@
 #include "deltabasic_config.h"
 #include "dmemory.h"
 #include "dstring.h"
+#include "dopcodes.h"
 
 
+/**
+ * Heap string of `size` characters with a single reference, only the null-terminal is set.
+ * Taken from `D->stringPool` when it fits a size class
+ */
+static delta_SString* AllocString(delta_SState* D, size_t size);
+
+/**
+ * Return `string` to its size class in `D->stringPool`, or free it
+ */
+static void FreeString(delta_SState* D, delta_SString* string);
+
 // ******************************************************************************** //
 
+/* ****************************************
+ * delta_FindLine
+ */
+delta_TBool delta_FindLine(const delta_SState* D, size_t number, size_t* index) {
+	size_t low = 0;
+	size_t high = D->lineVector.size;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		const size_t line = D->lineVector.array[middle]->line;
+
+		if (line == number) {
+			*index = middle;
+			return dtrue;
+		}
+
+		if (line < number)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	*index = low;
+	return dfalse;
+}
+
+/* ****************************************
+ * delta_IsExecLineLive
+ */
+delta_TBool delta_IsExecLineLive(const delta_SState* D) {
+	delta_TBool bExec = (D->currentLine == D->execLine);
+	for (size_t i = 0; i < D->returnHead; ++i)
+		bExec |= (D->returnStack[i].line == D->execLine);
+
+	for (size_t i = 0; i < D->forHead; ++i)
+		bExec |= (D->forStack[i].startLine == D->execLine);
+
+	return bExec;
+}
+
 /* ****************************************
  * delta_InsertLine
  */
@@ -22,8 +73,25 @@ delta_TBool delta_InsertLine(delta_SState* D, size_t lineNumber, const delta_TCh
 	if ((D == NULL) || (str == NULL))
 		return dfalse;
 
+	delta_SLineVector* vector = &(D->lineVector);
+	if (vector->size == vector->allocated) {
+		const size_t newSize = (vector->allocated == 0) ? DELTABASIC_LINE_VECTOR_START_SIZE : vector->allocated * 2;
+
+		delta_SLine** array = (delta_SLine**)DELTA_Alloc(D, DELTA_MEMORY_LINES, sizeof(delta_SLine*) * newSize); // Not realloc, a failure keeps the vector
+		if (array == NULL)
+			return dfalse;
+
+		if (vector->allocated != 0) {
+			memcpy(array, vector->array, sizeof(delta_SLine*) * vector->size);
+			DELTA_Free(D, DELTA_MEMORY_LINES, vector->array, sizeof(delta_SLine*) * vector->allocated);
+		}
+
+		vector->array		= array;
+		vector->allocated	= newSize;
+	}
+
 	const size_t blockSize = sizeof(delta_SLine) + sizeof(delta_TChar) * (strSize + 1);
-	delta_SLine* line = (delta_SLine*)DELTA_Alloc(D, blockSize);
+	delta_SLine* line = (delta_SLine*)DELTA_ArenaAlloc(D, DELTA_MEMORY_LINES, blockSize);
 	if (line == NULL)
 		return dfalse;
 
@@ -32,110 +100,169 @@ delta_TBool delta_InsertLine(delta_SState* D, size_t lineNumber, const delta_TCh
 	line->str = (char*)(((delta_TByte*)line) + sizeof(delta_SLine));
 	memcpy(line->str, str, strSize);
 
-	if (D->head == NULL) { // List is empty
-		D->head = line;
-		D->tail = line;
-		return dtrue;
-	}
-	else if (D->head->line > lineNumber) { // Less than the first line
-		line->next = D->head;
-		line->prev = NULL;
-
-		line->next->prev = line;
+	D->bCompiled = dfalse; // The line indices of the linked jumps move, see `delta_Link`
 
-		D->head = line;
-
-		return dtrue;
-	}
-	else if (D->tail->line < lineNumber) { // Greater than the last line
-		line->next = NULL;
-		line->prev = D->tail;
+	size_t index = vector->size;
+	if ((vector->size != 0) && (D->tail->line >= lineNumber)) { // Not appended
+		if (delta_FindLine(D, lineNumber, &index) == dtrue) { // Replace
+			delta_SLine* node = vector->array[index];
 
-		line->prev->next = line;
-
-		D->tail = line;
-
-		return dtrue;
-	}
-
-	delta_SLine* node = D->head;
-	while (node != NULL) {
-		if (node->line == lineNumber) { // Replace
 			line->prev = node->prev;
 			line->next = node->next;
 
 			if (line->prev != NULL)
 				line->prev->next = line;
+			else
+				D->head = line;
 
 			if (line->next != NULL)
 				line->next->prev = line;
-
-			delta_FreeNode(D, node);
-			if (D->head == node)
-				D->head = line;
-
-			if (D->tail == node)
+			else
 				D->tail = line;
-			
-			return dtrue;
-		}
-		else if (node->line > lineNumber) { // Insert
-			line->next = node;
-			line->prev = node->prev;
 
-			line->prev->next = line;
-			line->next->prev = line;
+			vector->array[index] = line;
 
+			D->bytecodeGarbage += node->bytecodeSize;
+			D->constantsGarbage += node->constants;
+			delta_FreeNode(D, node);
 			return dtrue;
 		}
 
-		node = node->next;
+		memmove(vector->array + index + 1, vector->array + index, sizeof(delta_SLine*) * (vector->size - index));
 	}
 
-	delta_FreeNode(D, line);
+	vector->array[index] = line;
+	++(vector->size);
 
-	return dfalse;
+	line->prev = (index != 0) ? vector->array[index - 1] : NULL;
+	line->next = (index + 1 != vector->size) ? vector->array[index + 1] : NULL;
+
+	if (line->prev != NULL)
+		line->prev->next = line;
+	else
+		D->head = line;
+
+	if (line->next != NULL)
+		line->next->prev = line;
+	else
+		D->tail = line;
+
+	return dtrue;
 }
 
 /* ****************************************
  * delta_RemoveLine
  */
 void delta_RemoveLine(delta_SState* D, size_t line) {
-	if (D->head == NULL)
-		return;
-	else if (D->head->line > line)
-		return;
-	else if (D->tail->line < line)
+	size_t index = 0;
+	if (delta_FindLine(D, line, &index) == dfalse)
 		return;
 
-	delta_SLine* node = D->head;
-	while (node != NULL) {
-		if (node->line == line) {
-			if (D->head == node)
-				D->head = node->next;
+	delta_SLineVector* vector = &(D->lineVector);
+	delta_SLine* node = vector->array[index];
 
-			if (D->tail == node)
-				D->tail = node->prev;
-				
-			if (node->prev != NULL)
-				node->prev->next = node->next;
+	D->bCompiled = dfalse; // The line indices of the linked jumps move, see `delta_Link`
 
-			if (node->next != NULL)
-				node->next->prev = node->prev;
+	--(vector->size);
+	memmove(vector->array + index, vector->array + index + 1, sizeof(delta_SLine*) * (vector->size - index));
 
-			delta_FreeNode(D, node);
-			return;
-		}
+	if (node->prev != NULL)
+		node->prev->next = node->next;
+	else
+		D->head = node->next;
 
-		node = node->next;
-	}
+	if (node->next != NULL)
+		node->next->prev = node->prev;
+	else
+		D->tail = node->prev;
+
+	D->bytecodeGarbage += node->bytecodeSize;
+	D->constantsGarbage += node->constants;
+	delta_FreeNode(D, node);
 }
 
 /* ****************************************
  * delta_FreeNode
  */
 inline void delta_FreeNode(delta_SState* D, delta_SLine* line) {
-	DELTA_Free(D, line, sizeof(delta_SLine) + (delta_Strlen(line->str) + 1) * sizeof(delta_TChar));
+	DELTA_ArenaFree(D, DELTA_MEMORY_LINES, line, sizeof(delta_SLine) + (delta_Strlen(line->str) + 1) * sizeof(delta_TChar));
+}
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * FindName
+ *
+ * Entry of `str` or the free entry where it would go, `NULL` if `table` is empty
+ */
+static delta_SNameEntry* FindName(const delta_SNameTable* table, const delta_TChar str[], uint16_t size, uint32_t hash) {
+	if (table->allocated == 0)
+		return NULL;
+
+	const size_t mask = table->allocated - 1;
+	for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+		delta_SNameEntry* entry = &(table->entries[i]);
+		if (entry->name == NULL)
+			return entry;
+
+		if ((entry->hash == hash) && (entry->size == size) && (memcmp(entry->name, str, sizeof(delta_TChar) * size) == 0))
+			return entry;
+	}
+}
+
+/* ****************************************
+ * InsertName
+ *
+ * `name` must not be in `table`, see `ReserveName`
+ */
+static void InsertName(delta_SNameTable* table, const delta_TChar name[], uint16_t size, uint32_t hash, void* value) {
+	delta_SNameEntry* entry = FindName(table, name, size, hash);
+
+	entry->name		= name;
+	entry->value	= value;
+	entry->hash		= hash;
+	entry->size		= size;
+
+	++(table->size);
+}
+
+/* ****************************************
+ * ReserveName
+ *
+ * Make room for one more entry, rehashing into a table twice as large if needed
+ */
+static delta_TBool ReserveName(delta_SState* D, delta_SNameTable* table, delta_EMemoryCategory category) {
+	if ((table->size + 1) * 2 <= table->allocated)
+		return dtrue;
+
+	delta_SNameTable grown = { 0 };
+	grown.allocated	= (table->allocated == 0) ? DELTABASIC_NAME_TABLE_START_SIZE : table->allocated * 2;
+	grown.entries	= (delta_SNameEntry*)DELTA_Alloc(D, category, sizeof(delta_SNameEntry) * grown.allocated);
+	if (grown.entries == NULL)
+		return dfalse;
+
+	memset(grown.entries, 0x00, sizeof(delta_SNameEntry) * grown.allocated);
+
+	for (size_t i = 0; i < table->allocated; ++i) {
+		const delta_SNameEntry* entry = &(table->entries[i]);
+		if (entry->name != NULL)
+			InsertName(&grown, entry->name, entry->size, entry->hash, entry->value);
+	}
+
+	delta_FreeNameTable(D, table, category);
+	*table = grown;
+
+	return dtrue;
+}
+
+/* ****************************************
+ * delta_FreeNameTable
+ */
+void delta_FreeNameTable(delta_SState* D, delta_SNameTable* table, delta_EMemoryCategory category) {
+	if (table->allocated != 0)
+		DELTA_Free(D, category, table->entries, sizeof(delta_SNameEntry) * table->allocated);
+
+	memset(table, 0x00, sizeof(delta_SNameTable));
 }
 
 // ******************************************************************************** //
@@ -147,16 +274,17 @@ delta_SNumericVariable* delta_FindOrAddNumericVariable(delta_SState* D, const de
 	if (D == NULL)
 		return NULL;
 
-	delta_SNumericVariable* var = D->numericValiables;
-	while (var != NULL) {
-		if (delta_Strncmp(var->name, str, size) == 0)
-			return var;
+	const uint32_t hash = delta_Hash(str, size);
 
-		var = var->next;
-	}
+	const delta_SNameEntry* entry = FindName(&(D->numericVariables), str, size, hash);
+	if ((entry != NULL) && (entry->name != NULL))
+		return (delta_SNumericVariable*)(entry->value);
+
+	if (ReserveName(D, &(D->numericVariables), DELTA_MEMORY_VARIABLES) == dfalse)
+		return NULL;
 
 	const size_t blockSize = sizeof(delta_SNumericVariable) + sizeof(delta_TChar) * (size + 1);
-	var = (delta_SNumericVariable*)DELTA_Alloc(D, blockSize);
+	delta_SNumericVariable* var = (delta_SNumericVariable*)DELTA_ArenaAlloc(D, DELTA_MEMORY_VARIABLES, blockSize);
 	if (var == NULL)
 		return NULL;
 
@@ -164,8 +292,42 @@ delta_SNumericVariable* delta_FindOrAddNumericVariable(delta_SState* D, const de
 	var->name = (delta_TChar*)(((delta_TByte*)var) + sizeof(delta_SNumericVariable));
 	memcpy(var->name, str, size);
 
-	var->next = D->numericValiables;
-	D->numericValiables = var;
+	delta_SNumericSlots* slots = &(D->numericSlots);
+	if (slots->size + 1 >= slots->allocated) {
+		const size_t newSize = (slots->allocated == 0) ? DELTABASIC_VARIABLE_SLOTS_START_SIZE : slots->allocated * 2;
+
+		delta_TNumber* values = (delta_TNumber*)DELTA_Alloc(D, DELTA_MEMORY_VARIABLES, sizeof(delta_TNumber) * newSize);
+		delta_SNumericVariable** variables = (delta_SNumericVariable**)DELTA_Alloc(D, DELTA_MEMORY_VARIABLES, sizeof(delta_SNumericVariable*) * newSize);
+		if ((values == NULL) || (variables == NULL)) {
+			if (values != NULL)
+				DELTA_Free(D, DELTA_MEMORY_VARIABLES, values, sizeof(delta_TNumber) * newSize);
+
+			if (variables != NULL)
+				DELTA_Free(D, DELTA_MEMORY_VARIABLES, variables, sizeof(delta_SNumericVariable*) * newSize);
+
+			delta_FreeNumericVariable(D, var);
+			return NULL;
+		}
+
+		if (slots->allocated != 0) {
+			memcpy(values, slots->values, sizeof(delta_TNumber) * slots->size);
+			memcpy(variables, slots->variables, sizeof(delta_SNumericVariable*) * slots->size);
+
+			DELTA_Free(D, DELTA_MEMORY_VARIABLES, slots->values, sizeof(delta_TNumber) * slots->allocated);
+			DELTA_Free(D, DELTA_MEMORY_VARIABLES, slots->variables, sizeof(delta_SNumericVariable*) * slots->allocated);
+		}
+
+		slots->values		= values;
+		slots->variables	= variables;
+		slots->allocated	= newSize;
+	}
+
+	var->slot = slots->size;
+	slots->values[var->slot] = 0.0f;
+	slots->variables[var->slot] = var;
+	++(slots->size);
+
+	InsertName(&(D->numericVariables), var->name, size, hash, var);
 
 	return var;
 }
@@ -174,7 +336,7 @@ delta_SNumericVariable* delta_FindOrAddNumericVariable(delta_SState* D, const de
  * delta_FreeNumericVariable
  */
 void delta_FreeNumericVariable(delta_SState* D, delta_SNumericVariable* variable) {
-	DELTA_Free(D, variable, sizeof(delta_SNumericVariable) + (delta_Strlen(variable->name) + 1) * sizeof(delta_TChar));
+	DELTA_ArenaFree(D, DELTA_MEMORY_VARIABLES, variable, sizeof(delta_SNumericVariable) + (delta_Strlen(variable->name) + 1) * sizeof(delta_TChar));
 }
 
 // ******************************************************************************** //
@@ -186,16 +348,17 @@ delta_SStringVariable* delta_FindOrAddStringVariable(delta_SState* D, const delt
 	if (D == NULL)
 		return NULL;
 
-	delta_SStringVariable* var = D->stringVariables;
-	while (var != NULL) {
-		if (delta_Strncmp(var->name, str, size) == 0)
-			return var;
+	const uint32_t hash = delta_Hash(str, size);
 
-		var = var->next;
-	}
+	const delta_SNameEntry* entry = FindName(&(D->stringVariables), str, size, hash);
+	if ((entry != NULL) && (entry->name != NULL))
+		return (delta_SStringVariable*)(entry->value);
+
+	if (ReserveName(D, &(D->stringVariables), DELTA_MEMORY_VARIABLES) == dfalse)
+		return NULL;
 
 	const size_t blockSize = sizeof(delta_SStringVariable) + sizeof(delta_TChar) * (size + 1);
-	var = (delta_SStringVariable*)DELTA_Alloc(D, blockSize);
+	delta_SStringVariable* var = (delta_SStringVariable*)DELTA_ArenaAlloc(D, DELTA_MEMORY_VARIABLES, blockSize);
 	if (var == NULL)
 		return NULL;
 
@@ -203,8 +366,42 @@ delta_SStringVariable* delta_FindOrAddStringVariable(delta_SState* D, const delt
 	var->name = (delta_TChar*)(((delta_TByte*)var) + sizeof(delta_SStringVariable));
 	memcpy(var->name, str, size);
 
-	var->next = D->stringVariables;
-	D->stringVariables = var;
+	delta_SStringSlots* slots = &(D->stringSlots);
+	if (slots->size + 1 >= slots->allocated) {
+		const size_t newSize = (slots->allocated == 0) ? DELTABASIC_VARIABLE_SLOTS_START_SIZE : slots->allocated * 2;
+
+		delta_UStringValue* values = (delta_UStringValue*)DELTA_Alloc(D, DELTA_MEMORY_VARIABLES, sizeof(delta_UStringValue) * newSize);
+		delta_SStringVariable** variables = (delta_SStringVariable**)DELTA_Alloc(D, DELTA_MEMORY_VARIABLES, sizeof(delta_SStringVariable*) * newSize);
+		if ((values == NULL) || (variables == NULL)) {
+			if (values != NULL)
+				DELTA_Free(D, DELTA_MEMORY_VARIABLES, values, sizeof(delta_UStringValue) * newSize);
+
+			if (variables != NULL)
+				DELTA_Free(D, DELTA_MEMORY_VARIABLES, variables, sizeof(delta_SStringVariable*) * newSize);
+
+			delta_FreeStringVariable(D, var);
+			return NULL;
+		}
+
+		if (slots->allocated != 0) {
+			memcpy(values, slots->values, sizeof(delta_UStringValue) * slots->size);
+			memcpy(variables, slots->variables, sizeof(delta_SStringVariable*) * slots->size);
+
+			DELTA_Free(D, DELTA_MEMORY_VARIABLES, slots->values, sizeof(delta_UStringValue) * slots->allocated);
+			DELTA_Free(D, DELTA_MEMORY_VARIABLES, slots->variables, sizeof(delta_SStringVariable*) * slots->allocated);
+		}
+
+		slots->values		= values;
+		slots->variables	= variables;
+		slots->allocated	= newSize;
+	}
+
+	var->slot = slots->size;
+	memset(&(slots->values[var->slot]), 0x00, sizeof(delta_UStringValue));
+	slots->variables[var->slot] = var;
+	++(slots->size);
+
+	InsertName(&(D->stringVariables), var->name, size, hash, var);
 
 	return var;
 }
@@ -213,11 +410,7 @@ delta_SStringVariable* delta_FindOrAddStringVariable(delta_SState* D, const delt
  * delta_FreeStringVariable
  */
 void delta_FreeStringVariable(delta_SState* D, delta_SStringVariable* variable) {
-	if (variable->str != NULL) {
-		DELTA_Free(D, variable->str, (delta_Strlen(variable->str) + 1) * sizeof(delta_TChar));
-	}
-
-	DELTA_Free(D, variable, sizeof(delta_SStringVariable) + (delta_Strlen(variable->name) + 1) * sizeof(delta_TChar));
+	DELTA_ArenaFree(D, DELTA_MEMORY_VARIABLES, variable, sizeof(delta_SStringVariable) + (delta_Strlen(variable->name) + 1) * sizeof(delta_TChar));
 }
 
 // ******************************************************************************** //
@@ -229,16 +422,17 @@ delta_SNumericArray* delta_FindOrAddNumericArray(delta_SState* D, const delta_TC
 	if (D == NULL)
 		return NULL;
 
-	delta_SNumericArray* var = D->numericArrays;
-	while (var != NULL) {
-		if (delta_Strncmp(var->name, str, size) == 0)
-			return var;
+	const uint32_t hash = delta_Hash(str, size);
 
-		var = var->next;
-	}
+	const delta_SNameEntry* entry = FindName(&(D->numericArrays), str, size, hash);
+	if ((entry != NULL) && (entry->name != NULL))
+		return (delta_SNumericArray*)(entry->value);
+
+	if (ReserveName(D, &(D->numericArrays), DELTA_MEMORY_ARRAYS) == dfalse)
+		return NULL;
 
 	const size_t blockSize = sizeof(delta_SNumericArray) + sizeof(delta_TChar) * (size + 1);
-	var = (delta_SNumericArray*)DELTA_Alloc(D, blockSize);
+	delta_SNumericArray* var = (delta_SNumericArray*)DELTA_ArenaAlloc(D, DELTA_MEMORY_ARRAYS, blockSize);
 	if (var == NULL)
 		return NULL;
 
@@ -246,8 +440,7 @@ delta_SNumericArray* delta_FindOrAddNumericArray(delta_SState* D, const delta_TC
 	var->name = (delta_TChar*)(((delta_TByte*)var) + sizeof(delta_SNumericArray));
 	memcpy(var->name, str, size);
 
-	var->next = D->numericArrays;
-	D->numericArrays = var;
+	InsertName(&(D->numericArrays), var->name, size, hash, var);
 
 	return var;
 }
@@ -257,10 +450,10 @@ delta_SNumericArray* delta_FindOrAddNumericArray(delta_SState* D, const delta_TC
  */
 void delta_FreeNumericArray(delta_SState* D, delta_SNumericArray* array) {
 	if (array->array != NULL) {
-		DELTA_Free(D, array->array, sizeof(delta_TNumber) * (array->size));
+		DELTA_Free(D, DELTA_MEMORY_ARRAYS, array->array, sizeof(delta_TNumber) * (array->size));
 	}
 
-	DELTA_Free(D, array, sizeof(delta_SNumericArray) + (delta_Strlen(array->name) + 1) * sizeof(delta_TChar));
+	DELTA_ArenaFree(D, DELTA_MEMORY_ARRAYS, array, sizeof(delta_SNumericArray) + (delta_Strlen(array->name) + 1) * sizeof(delta_TChar));
 }
 
 // ******************************************************************************** //
@@ -272,16 +465,17 @@ delta_SStringArray* delta_FindOrAddStringArray(delta_SState* D, const delta_TCha
 	if (D == NULL)
 		return NULL;
 
-	delta_SStringArray* var = D->stringArrays;
-	while (var != NULL) {
-		if (delta_Strncmp(var->name, str, size) == 0)
-			return var;
+	const uint32_t hash = delta_Hash(str, size);
 
-		var = var->next;
-	}
+	const delta_SNameEntry* entry = FindName(&(D->stringArrays), str, size, hash);
+	if ((entry != NULL) && (entry->name != NULL))
+		return (delta_SStringArray*)(entry->value);
+
+	if (ReserveName(D, &(D->stringArrays), DELTA_MEMORY_ARRAYS) == dfalse)
+		return NULL;
 
 	const size_t blockSize = sizeof(delta_SStringArray) + sizeof(delta_TChar) * (size + 1);
-	var = (delta_SStringArray*)DELTA_Alloc(D, blockSize);
+	delta_SStringArray* var = (delta_SStringArray*)DELTA_ArenaAlloc(D, DELTA_MEMORY_ARRAYS, blockSize);
 	if (var == NULL)
 		return NULL;
 
@@ -289,8 +483,7 @@ delta_SStringArray* delta_FindOrAddStringArray(delta_SState* D, const delta_TCha
 	var->name = (delta_TChar*)(((delta_TByte*)var) + sizeof(delta_SStringArray));
 	memcpy(var->name, str, size);
 
-	var->next = D->stringArrays;
-	D->stringArrays = var;
+	InsertName(&(D->stringArrays), var->name, size, hash, var);
 
 	return var;
 }
@@ -300,16 +493,13 @@ delta_SStringArray* delta_FindOrAddStringArray(delta_SState* D, const delta_TCha
  */
 void delta_FreeStringArray(delta_SState* D, delta_SStringArray* array) {
 	if (array->array != NULL) {
-		for (size_t i = 0; i < array->size; ++i) {
-			if (array->array[i] != NULL) {
-				DELTA_Free(D, array->array[i], (delta_Strlen(array->array[i]) + 1) * sizeof(delta_TChar));
-			}
-		}
+		for (size_t i = 0; i < array->size; ++i)
+			delta_ReleaseStringValue(D, &(array->array[i]));
 
-		DELTA_Free(D, array->array, sizeof(delta_TChar*) * (array->size));
+		DELTA_Free(D, DELTA_MEMORY_ARRAYS, array->array, sizeof(delta_UStringValue) * (array->size));
 	}
 
-	DELTA_Free(D, array, sizeof(delta_SStringArray) + (delta_Strlen(array->name) + 1) * sizeof(delta_TChar));
+	DELTA_ArenaFree(D, DELTA_MEMORY_ARRAYS, array, sizeof(delta_SStringArray) + (delta_Strlen(array->name) + 1) * sizeof(delta_TChar));
 }
 
 // ******************************************************************************** //
@@ -319,33 +509,383 @@ void delta_FreeStringArray(delta_SState* D, delta_SStringArray* array) {
  */
 void delta_FreeStringStack(delta_SState* D) {
 	for (size_t i = 0; i < D->stringHead; ++i) {
-		DELTA_Free(D, D->stringStack[i], (delta_Strlen(D->stringStack[i]) + 1) * sizeof(delta_TChar));
+		delta_ReleaseStringValue(D, &(D->stringStack[i]));
 	}
 
 	D->stringHead = 0;
 }
 
+/* ****************************************
+ * StringPoolClass
+ *
+ * `DELTABASIC_STRING_POOL_CLASSES` if a string of `capacity` characters isn't pooled
+ */
+static size_t StringPoolClass(size_t capacity) {
+	size_t class = 0;
+	while ((class < DELTABASIC_STRING_POOL_CLASSES) && (capacity + 1 > (DELTA_STRING_POOL_MIN_SIZE << class)))
+		++class;
+
+	return class;
+}
+
+/* ****************************************
+ * AllocString
+ */
+delta_SString* AllocString(delta_SState* D, size_t size) {
+	delta_SString* string	= NULL;
+	size_t capacity			= size;
+
+	const size_t class = StringPoolClass(size);
+	if (class < DELTABASIC_STRING_POOL_CLASSES) {
+		capacity = (DELTA_STRING_POOL_MIN_SIZE << class) - 1;
+
+		string = D->stringPool.free[class];
+		if (string != NULL)
+			D->stringPool.free[class] = (delta_SString*)string->str;
+	}
+
+	if (string == NULL) {
+		string = (delta_SString*)DELTA_Alloc(D, DELTA_MEMORY_STRINGS, sizeof(delta_SString) + sizeof(delta_TChar) * (capacity + 1));
+		if (string == NULL)
+			return NULL;
+	}
+
+	string->refCount	= 1;
+	string->size		= size;
+	string->capacity	= capacity;
+	string->str			= (delta_TChar*)(((delta_TByte*)string) + sizeof(delta_SString));
+	string->str[size]	= '\0';
+
+	return string;
+}
+
+/* ****************************************
+ * FreeString
+ */
+void FreeString(delta_SState* D, delta_SString* string) {
+	const size_t class = StringPoolClass(string->capacity);
+	if ((class < DELTABASIC_STRING_POOL_CLASSES) && (string->capacity + 1 == (DELTA_STRING_POOL_MIN_SIZE << class))) {
+		string->str = (delta_TChar*)D->stringPool.free[class];
+		D->stringPool.free[class] = string;
+
+		return;
+	}
+
+	DELTA_Free(D, DELTA_MEMORY_STRINGS, string, sizeof(delta_SString) + sizeof(delta_TChar) * (string->capacity + 1));
+}
+
+/* ****************************************
+ * delta_FreeStringPool
+ */
+void delta_FreeStringPool(delta_SState* D) {
+	for (size_t class = 0; class < DELTABASIC_STRING_POOL_CLASSES; ++class) {
+		delta_SString* string = D->stringPool.free[class];
+		while (string != NULL) {
+			delta_SString* next = (delta_SString*)string->str;
+
+			DELTA_Free(D, DELTA_MEMORY_STRINGS, string, sizeof(delta_SString) + sizeof(delta_TChar) * (string->capacity + 1));
+
+			string = next;
+		}
+
+		D->stringPool.free[class] = NULL;
+	}
+}
+
+/* ****************************************
+ * delta_CreateStringValue
+ */
+delta_TBool delta_CreateStringValue(delta_SState* D, delta_UStringValue* value, const delta_TChar str[], size_t size) {
+	if (size <= DELTA_STRING_SMALL_SIZE) {
+		memset(value, 0x00, sizeof(delta_UStringValue));
+		memcpy(value->small, str, sizeof(delta_TChar) * size);
+		value->small[DELTA_STRING_SMALL_SIZE + 1] = (delta_TChar)size;
+
+		return dtrue;
+	}
+
+	delta_SString* string = AllocString(D, size);
+	if (string == NULL)
+		return dfalse;
+
+	memcpy(string->str, str, sizeof(delta_TChar) * size);
+
+	value->heap = string;
+	value->small[DELTA_STRING_SMALL_SIZE + 1] = (delta_TChar)DELTA_STRING_HEAP;
+
+	return dtrue;
+}
+
+/* ****************************************
+ * delta_RetainStringValue
+ */
+inline void delta_RetainStringValue(const delta_UStringValue* value) {
+	if (DELTA_STRING_IS_HEAP(value))
+		++(value->heap->refCount);
+}
+
+/* ****************************************
+ * delta_ReleaseStringValue
+ */
+inline void delta_ReleaseStringValue(delta_SState* D, delta_UStringValue* value) {
+	if (DELTA_STRING_IS_HEAP(value)) {
+		delta_SString* string = value->heap;
+		if (--(string->refCount) == 0)
+			FreeString(D, string);
+	}
+
+	memset(value, 0x00, sizeof(delta_UStringValue));
+}
+
+/* ****************************************
+ * delta_ResizeStringValue
+ */
+delta_TBool delta_ResizeStringValue(delta_SState* D, delta_UStringValue* value, size_t size) {
+	if (DELTA_STRING_IS_HEAP(value) == dfalse) {
+		if (size <= DELTA_STRING_SMALL_SIZE) {
+			value->small[size] = '\0';
+			value->small[DELTA_STRING_SMALL_SIZE + 1] = (delta_TChar)size;
+
+			return dtrue;
+		}
+
+		delta_SString* string = AllocString(D, size);
+		if (string == NULL)
+			return dfalse;
+
+		memcpy(string->str, value->small, sizeof(delta_TChar) * DELTA_STRING_TAG(value));
+
+		value->heap = string;
+		value->small[DELTA_STRING_SMALL_SIZE + 1] = (delta_TChar)DELTA_STRING_HEAP;
+
+		return dtrue;
+	}
+
+	delta_SString* string = value->heap;
+	if (size <= DELTA_STRING_SMALL_SIZE) { // Shrinks back inline
+		delta_UStringValue small = { 0 };
+		memcpy(small.small, string->str, sizeof(delta_TChar) * DELTABASIC_MIN(size, string->size));
+		small.small[DELTA_STRING_SMALL_SIZE + 1] = (delta_TChar)size;
+
+		delta_ReleaseStringValue(D, value);
+		*value = small;
+
+		return dtrue;
+	}
+
+	if (string->refCount != 1) { // Shared, copy on write
+		delta_SString* copy = AllocString(D, size);
+		if (copy == NULL)
+			return dfalse;
+
+		memcpy(copy->str, string->str, sizeof(delta_TChar) * DELTABASIC_MIN(size, string->size));
+
+		--(string->refCount);
+		value->heap = copy;
+
+		return dtrue;
+	}
+
+	if (size > string->capacity) {
+		const size_t capacity = DELTABASIC_MAX(size, string->capacity * 2);
+
+		if (StringPoolClass(string->capacity) < DELTABASIC_STRING_POOL_CLASSES) { // Moves out of its size class
+			delta_SString* copy = AllocString(D, capacity);
+			if (copy == NULL)
+				return dfalse;
+
+			memcpy(copy->str, string->str, sizeof(delta_TChar) * string->size);
+
+			FreeString(D, string);
+			string = copy;
+		}
+		else {
+			string = (delta_SString*)DELTA_Realloc(D, DELTA_MEMORY_STRINGS, string, sizeof(delta_SString) + sizeof(delta_TChar) * (string->capacity + 1), sizeof(delta_SString) + sizeof(delta_TChar) * (capacity + 1));
+			if (string == NULL)
+				return dfalse;
+
+			string->capacity	= capacity;
+			string->str			= (delta_TChar*)(((delta_TByte*)string) + sizeof(delta_SString));
+		}
+
+		value->heap = string;
+	}
+
+	string->size = size;
+	string->str[size] = '\0';
+
+	return dtrue;
+}
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * delta_AddStringConstant
+ */
+delta_TBool delta_AddStringConstant(delta_SState* D, delta_SStringConstants* constants, const delta_TChar str[], size_t size, size_t* index) {
+	for (size_t i = 0; i < constants->size; ++i) {
+		const delta_UStringValue* constant = &(constants->strings[i]);
+		if ((DELTA_STRING_SIZE(constant) == size) && (memcmp(DELTA_STRING_DATA(constant), str, sizeof(delta_TChar) * size) == 0)) {
+			*index = i;
+			return dtrue;
+		}
+	}
+
+	if (constants->size > DELTA_STRING_CONSTANT_INDEX_MASK)
+		return dfalse;
+
+	if (constants->size == constants->allocated) {
+		const size_t newSize = (constants->allocated == 0) ? DELTABASIC_STRING_CONSTANTS_START_SIZE : constants->allocated * 2;
+
+		delta_UStringValue* strings = (delta_UStringValue*)DELTA_Realloc(D, DELTA_MEMORY_STRINGS, constants->strings, sizeof(delta_UStringValue) * constants->allocated, sizeof(delta_UStringValue) * newSize);
+		if (strings == NULL)
+			return dfalse;
+
+		constants->strings		= strings;
+		constants->allocated	= newSize;
+	}
+
+	if (delta_CreateStringValue(D, &(constants->strings[constants->size]), str, size) == dfalse)
+		return dfalse;
+
+	*index = constants->size;
+	++(constants->size);
+
+	return dtrue;
+}
+
+/* ****************************************
+ * delta_ClearStringConstants
+ */
+void delta_ClearStringConstants(delta_SState* D, delta_SStringConstants* constants, delta_TBool bRelease) {
+	for (size_t i = 0; i < constants->size; ++i) {
+		delta_ReleaseStringValue(D, &(constants->strings[i])); // Still alive if a variable holds it
+	}
+
+	constants->size = 0;
+
+	if ((bRelease == dtrue) && (constants->allocated != 0)) {
+		DELTA_Free(D, DELTA_MEMORY_STRINGS, constants->strings, sizeof(delta_UStringValue) * constants->allocated);
+
+		constants->strings		= NULL;
+		constants->allocated	= 0;
+	}
+}
+
 // ******************************************************************************** //
 
 /* ****************************************
  * delta_FindCFunction
  */
 delta_TBool delta_FindCFunction(delta_SState* D, const delta_TChar name[], uint16_t size, size_t* index) {
-	for (size_t i = 0; i < D->cfuncVector.size; ++i) {
-		if (delta_Strncmp(name, D->cfuncVector.array[i]->name, size) == 0) {
-			if (index != NULL)
-				*index = i;
+	const delta_SNameEntry* entry = FindName(&(D->cfuncVector.names), name, size, delta_Hash(name, size));
+	if ((entry == NULL) || (entry->name == NULL))
+		return dfalse;
 
-			return dtrue;
+	if (index != NULL)
+		*index = (size_t)(uintptr_t)(entry->value);
+
+	return dtrue;
+}
+
+/* ****************************************
+ * delta_AddCFunction
+ */
+delta_TBool delta_AddCFunction(delta_SState* D, delta_SCFunction* function) {
+	delta_SCFuncVector* vector = &(D->cfuncVector);
+	if (ReserveName(D, &(vector->names), DELTA_MEMORY_CFUNCTIONS) == dfalse)
+		return dfalse;
+
+	if (vector->size + 1 >= vector->allocated) {
+		const size_t newSize = vector->allocated * 2;
+
+		delta_SCFunction** array = (delta_SCFunction**)DELTA_Realloc(D, DELTA_MEMORY_CFUNCTIONS, vector->array, sizeof(delta_SCFunction*) * vector->allocated, sizeof(delta_SCFunction*) * newSize);
+		if (array == NULL) {
+			vector->array		= NULL; // Freed by the allocator
+			vector->allocated	= 0;
+			return dfalse;
 		}
+
+		vector->array		= array;
+		vector->allocated	= newSize;
 	}
 
-	return dfalse;
+	const uint16_t size = (uint16_t)delta_Strlen(function->name);
+	InsertName(&(vector->names), function->name, size, delta_Hash(function->name, size), (void*)(uintptr_t)(vector->size));
+
+	vector->array[vector->size] = function;
+	++(vector->size);
+
+	return dtrue;
 }
 
 /* ****************************************
  * delta_FreeCFunction
  */
 void delta_FreeCFunction(delta_SState* D, delta_SCFunction* function) {
-	DELTA_Free(D, function, sizeof(delta_SCFunction) + (delta_Strlen(function->name) + 1) * sizeof(delta_TChar));
-}
\ No newline at end of file
+	DELTA_Free(D, DELTA_MEMORY_CFUNCTIONS, function, sizeof(delta_SCFunction) + (delta_Strlen(function->name) + 1) * sizeof(delta_TChar));
+}
+// ******************************************************************************** //
+
+/* ****************************************
+ * delta_FindOrAddSample
+ */
+delta_SSample* delta_FindOrAddSample(delta_SState* D, const delta_TChar str[], uint16_t size) {
+	delta_SSampleVector* vector = &(D->samples);
+	const uint32_t hash = delta_Hash(str, size);
+
+	const delta_SNameEntry* entry = FindName(&(vector->names), str, size, hash);
+	if ((entry != NULL) && (entry->name != NULL))
+		return (delta_SSample*)(entry->value);
+
+	if (ReserveName(D, &(vector->names), DELTA_MEMORY_PROFILE) == dfalse)
+		return NULL;
+
+	if (vector->size == vector->allocated) {
+		const size_t newSize = (vector->allocated == 0) ? DELTABASIC_SAMPLE_VECTOR_START_SIZE : vector->allocated * 2;
+
+		delta_SSample** array = (delta_SSample**)DELTA_Alloc(D, DELTA_MEMORY_PROFILE, sizeof(delta_SSample*) * newSize); // Not realloc, a failure keeps the vector
+		if (array == NULL)
+			return NULL;
+
+		if (vector->allocated != 0) {
+			memcpy(array, vector->array, sizeof(delta_SSample*) * vector->size);
+			DELTA_Free(D, DELTA_MEMORY_PROFILE, vector->array, sizeof(delta_SSample*) * vector->allocated);
+		}
+
+		vector->array		= array;
+		vector->allocated	= newSize;
+	}
+
+	const size_t blockSize = sizeof(delta_SSample) + sizeof(delta_TChar) * (size + 1);
+	delta_SSample* sample = (delta_SSample*)DELTA_Alloc(D, DELTA_MEMORY_PROFILE, blockSize);
+	if (sample == NULL)
+		return NULL;
+
+	memset(sample, 0x00, blockSize);
+	sample->name = (delta_TChar*)(((delta_TByte*)sample) + sizeof(delta_SSample));
+	memcpy(sample->name, str, sizeof(delta_TChar) * size);
+
+	vector->array[vector->size] = sample;
+	++(vector->size);
+
+	InsertName(&(vector->names), sample->name, size, hash, sample);
+
+	return sample;
+}
+
+/* ****************************************
+ * delta_FreeSamples
+ */
+void delta_FreeSamples(delta_SState* D) {
+	delta_SSampleVector* vector = &(D->samples);
+
+	for (size_t i = 0; i < vector->size; ++i)
+		DELTA_Free(D, DELTA_MEMORY_PROFILE, vector->array[i], sizeof(delta_SSample) + (delta_Strlen(vector->array[i]->name) + 1) * sizeof(delta_TChar));
+
+	if (vector->allocated != 0)
+		DELTA_Free(D, DELTA_MEMORY_PROFILE, vector->array, sizeof(delta_SSample*) * vector->allocated);
+
+	delta_FreeNameTable(D, &(vector->names), DELTA_MEMORY_PROFILE);
+	memset(vector, 0x00, sizeof(delta_SSampleVector));
+}
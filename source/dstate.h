@@ -8,9 +8,12 @@
 #define __DELTABASIC_STATE_H__
 
 #include <stddef.h>
+#include <signal.h>
 
 #include "deltabasic.h"
 #include "dlimits.h"
+#include "dmemory.h"
+#include "dopcodes.h"
 
 // ******************************************************************************** //
 
@@ -22,11 +25,50 @@ typedef struct delta_SLine {
 	char*			str; // Allocated at the end of the struct
 
 	size_t			offset; // In bytecode
+	size_t			bytecodeSize; // Of the segment at `offset`, zero until the line is compiled
+	size_t			constants; // String and register constants its segment added to the pools
+
+	delta_SProfileCounts profile; // See `DELTA_STATE_PROFILE`
 
 	struct delta_SLine* prev;
 	struct delta_SLine* next;
 } delta_SLine;
 
+/**
+ * delta_SLineVector
+ *
+ * Program lines in order, kept by `delta_InsertLine` and `delta_RemoveLine`
+ */
+typedef struct delta_SLineVector {
+	delta_SLine**		array;
+	size_t				size;
+	size_t				allocated;
+} delta_SLineVector;
+
+// ******************************************************************************** //
+
+/**
+ * delta_SNameEntry
+ */
+typedef struct delta_SNameEntry {
+	const delta_TChar*	name; // Of `value`, `NULL` if the entry is free
+	void*				value;
+	uint32_t			hash; // See `delta_Hash`
+	uint16_t			size;
+} delta_SNameEntry;
+
+/**
+ * delta_SNameTable
+ *
+ * Variables or arrays by name. Open addressing with linear probing, `allocated` is
+ * zero or a power of two and the table is kept at most half full
+ */
+typedef struct delta_SNameTable {
+	delta_SNameEntry*	entries;
+	size_t				size;
+	size_t				allocated;
+} delta_SNameTable;
+
 // ******************************************************************************** //
 
 /**
@@ -34,9 +76,7 @@ typedef struct delta_SLine {
  */
 typedef struct delta_SNumericVariable {
 	delta_TChar*	name; // Allocated at the end of the struct
-	delta_TNumber	value;
-
-	struct delta_SNumericVariable* next;
+	size_t			slot; // Index in `delta_SNumericSlots`
 } delta_SNumericVariable;
 
 /**
@@ -44,11 +84,88 @@ typedef struct delta_SNumericVariable {
  */
 typedef struct delta_SStringVariable {
 	delta_TChar*	name; // Allocated at the end of the struct
-	delta_TChar*	str;
-
-	struct delta_SStringVariable* next;
+	size_t			slot; // Index in `delta_SStringSlots`
 } delta_SStringVariable;
 
+/**
+ * delta_SNumericSlots
+ *
+ * Values of numeric variables, indexed by the slot resolved at compile time
+ */
+typedef struct delta_SNumericSlots {
+	delta_TNumber*				values;
+	delta_SNumericVariable**	variables;
+	size_t						size;
+	size_t						allocated;
+} delta_SNumericSlots;
+
+/**
+ * delta_SString
+ *
+ * Heap storage of the strings longer than `DELTA_STRING_SMALL_SIZE`. Shared by reference,
+ * copied only when a holder mutates it while it is shared
+ */
+typedef struct delta_SString {
+	size_t			refCount;
+	size_t			size; // Without the null-terminal
+	size_t			capacity; // Without the null-terminal, grows geometrically, see `delta_ResizeStringValue`
+	delta_TChar*	str; // Allocated at the end of the struct
+} delta_SString;
+
+#define DELTA_STRING_SMALL_SIZE				14 // Longest string stored inline
+#define DELTA_STRING_HEAP					0xFF // Tag of a `delta_UStringValue` referencing a `delta_SString`
+
+/**
+ * delta_UStringValue
+ *
+ * String held by a variable, an array element or the stack. All-zero is the empty string
+ */
+typedef union delta_UStringValue {
+	delta_TChar		small[DELTA_STRING_SMALL_SIZE + 2]; // Null-terminated characters, the last byte is the size or `DELTA_STRING_HEAP`
+	delta_SString*	heap;
+} delta_UStringValue;
+
+#define DELTA_STRING_TAG(value)				((delta_TByte)((value)->small[DELTA_STRING_SMALL_SIZE + 1]))
+#define DELTA_STRING_IS_HEAP(value)			(DELTA_STRING_TAG(value) == DELTA_STRING_HEAP)
+#define DELTA_STRING_DATA(value)			(DELTA_STRING_IS_HEAP(value) ? (value)->heap->str : (value)->small)
+#define DELTA_STRING_SIZE(value)			(DELTA_STRING_IS_HEAP(value) ? (value)->heap->size : (size_t)DELTA_STRING_TAG(value))
+
+/**
+ * delta_SStringPool
+ *
+ * Released heap strings kept for reuse, by size class. Class `i` holds
+ * `DELTA_STRING_POOL_MIN_SIZE << i` characters with the null-terminal.
+ * A free string is chained to the next one through its `str` field
+ */
+typedef struct delta_SStringPool {
+	delta_SString*	free[DELTABASIC_STRING_POOL_CLASSES];
+} delta_SStringPool;
+
+#define DELTA_STRING_POOL_MIN_SIZE			32
+
+/**
+ * delta_SStringSlots
+ *
+ * Values of string variables, indexed by the slot resolved at compile time
+ */
+typedef struct delta_SStringSlots {
+	delta_UStringValue*			values;
+	delta_SStringVariable**		variables;
+	size_t						size;
+	size_t						allocated;
+} delta_SStringSlots;
+
+/**
+ * delta_SStringConstants
+ *
+ * String literals interned at compile time, see `OPCODE_PUSHS`
+ */
+typedef struct delta_SStringConstants {
+	delta_UStringValue*			strings;
+	size_t						size;
+	size_t						allocated;
+} delta_SStringConstants;
+
 // ******************************************************************************** //
 
 /**
@@ -58,8 +175,6 @@ typedef struct delta_SNumericArray {
 	delta_TChar*	name; // Allocated at the end of the struct
 	delta_TNumber*	array;
 	size_t			size;
-
-	struct delta_SNumericArray* next;
 } delta_SNumericArray;
 
 /**
@@ -67,10 +182,8 @@ typedef struct delta_SNumericArray {
  */
 typedef struct delta_SStringArray {
 	delta_TChar*	name; // Allocated at the end of the struct
-	delta_TChar**	array;
+	delta_UStringValue*	array;
 	size_t			size;
-
-	struct delta_SStringArray* next;
 } delta_SStringArray;
 
 // ******************************************************************************** //
@@ -85,6 +198,11 @@ typedef struct delta_SReturnState {
 
 /**
  * delta_SForState
+ *
+ * The counter lives in the loop variable and `OPCODE_NEXTFOR` steps it in place.
+ * An integer counter kept here would have to be written back before every read
+ * of the variable: `OPCODE_GETN`, the superinstructions, the register tier and
+ * `delta_GetNumeric` all read the slot directly
  */
 typedef struct delta_SForState {
 	delta_SLine*	startLine;
@@ -93,9 +211,20 @@ typedef struct delta_SForState {
 	delta_TNumber	end;
 	delta_TNumber	step;
 
-	delta_SNumericVariable* counter;
+	size_t			counter; // Slot
 } delta_SForState;
 
+/**
+ * delta_SRegisterConstants
+ *
+ * Numeric constants of the program for the register tier
+ */
+typedef struct delta_SRegisterConstants {
+	delta_TNumber*		values;
+	size_t				size;
+	size_t				allocated;
+} delta_SRegisterConstants;
+
 // ******************************************************************************** //
 
 /**
@@ -121,11 +250,45 @@ typedef struct delta_SCFunction {
  * delta_SCFuncVector
  */
 typedef struct delta_SCFuncVector {
-	delta_SCFunction**	array;
+	delta_SCFunction**	array; // Indices are operands of `OPCODE_CALL`, they never move
 	size_t				size;
 	size_t				allocated;
+
+	delta_SNameTable	names; // Values are indices in `array`
 } delta_SCFuncVector;
 
+/**
+ * delta_SSample
+ */
+typedef struct delta_SSample {
+	delta_TChar*		name; // Folded stack, allocated at the end of the struct
+	size_t				count;
+} delta_SSample;
+
+/**
+ * delta_SSampleVector
+ *
+ * Distinct stacks sampled, see `DELTA_STATE_SAMPLE`
+ */
+typedef struct delta_SSampleVector {
+	delta_SSample**		array; // In the order they were first sampled
+	size_t				size;
+	size_t				allocated;
+
+	delta_SNameTable	names; // Values are samples of `array`
+} delta_SSampleVector;
+
+/**
+ * delta_SVerification
+ *
+ * What `delta_VerifyLine` proved about the stacks of some lines
+ */
+typedef struct delta_SVerification {
+	delta_TBool		bVerified; // Every line uses the stacks within a statement only, from the stack heads found at its start
+	size_t			numericDepth; // Most numbers a line has on the numeric stack at once
+	size_t			stringDepth;
+} delta_SVerification;
+
 // ******************************************************************************** //
 
 /**
@@ -138,23 +301,35 @@ struct delta_SState {
 	delta_TPrintFunction	printFunction;
 	delta_TInputFunction	inputFunction;
 
+	unsigned int			flags; // `delta_EStateFlags`
+	delta_SArena			arena; // See `DELTA_ArenaAlloc`
+	delta_SMemoryStats		memoryStats[DELTA_MEMORY_TOTAL + 1]; // See `DELTA_STATE_MEMORY_STATS`
+
 	size_t					ip; // Instruction Pointer
 	delta_SLine*			currentLine; // If `NULL`, do nothing (program `END`ed)
 
 	delta_SLine*			execLine;
 	size_t					lineNumber; // for errors
 
-	delta_SNumericVariable*	numericValiables;
-	delta_SStringVariable*	stringVariables;
+	delta_SNameTable		numericVariables; // Of `delta_SNumericVariable`
+	delta_SNameTable		stringVariables; // Of `delta_SStringVariable`
 
-	delta_SNumericArray*	numericArrays;
-	delta_SStringArray*		stringArrays;
+	delta_SNumericSlots		numericSlots;
+	delta_SStringSlots		stringSlots;
+
+	delta_SNameTable		numericArrays; // Of `delta_SNumericArray`
+	delta_SNameTable		stringArrays; // Of `delta_SStringArray`
 
 	size_t					numericHead;
 	delta_TNumber			numericStack[DELTABASIC_NUMERIC_STACK_SIZE];
 
 	size_t					stringHead;
-	delta_TChar*			stringStack[DELTABASIC_STRING_STACK_SIZE];
+	delta_UStringValue		stringStack[DELTABASIC_STRING_STACK_SIZE];
+
+	delta_SStringConstants	stringConstants;
+	delta_SStringConstants	execStringConstants;
+
+	delta_SStringPool		stringPool;
 
 	size_t					returnHead;
 	delta_SReturnState		returnStack[DELTABASIC_RETURN_STACK_SIZE];
@@ -162,30 +337,60 @@ struct delta_SState {
 	size_t					forHead;
 	delta_SForState			forStack[DELTABASIC_FOR_STACK_SIZE];
 
+	delta_TNumber				registerTemps[DELTABASIC_MACHINE_REGISTER_TEMPS];
+	delta_SRegisterConstants	registerConstants;
+	delta_TNumber				execConstants[DELTABASIC_EXEC_BYTECODE_SIZE / 5]; // At most one per `OPCODE_PUSHN` of the exec line
+	size_t						execConstantsSize;
+
 	delta_SCFuncVector		cfuncVector;
 	delta_SCFunction*		currentCFunc;
 	delta_UCFuncValue		cfuncArgs[DELTABASIC_CFUNC_MAX_ARGS];
+	delta_UStringValue		cfuncStrings[DELTABASIC_CFUNC_MAX_ARGS]; // String arguments, released after the call
 	delta_UCFuncValue		cfuncReturn;
+	delta_UStringValue		cfuncReturnString;
 	delta_TBool				bIgnoreCFuncReturn;
 
 	size_t					bytecodeSize;
-	delta_TByte*			bytecode;
+	delta_TByte*			bytecode; // Of the program lines
+	delta_TByte				execBytecode[DELTABASIC_EXEC_BYTECODE_SIZE];
+	delta_TBool				bAttached; // `bytecode` and `registerConstants` belong to a `delta_AttachImage` image and are never written
 
 	delta_TBool				bCompiled;
+	size_t					bytecodeEnd; // End of the line segments, zero if the next `delta_Compile` has to compile every line
+	size_t					bytecodeGarbage; // Size of the segments left by replaced and removed lines
+	size_t					constantsGarbage; // Constants of the pools left by replaced and removed lines
 
 	delta_SLine*			head;
 	delta_SLine*			tail;
+
+	delta_SLineVector		lineVector; // Jump targets, see `delta_Link`
+
+	delta_SVerification		verification; // Of the program lines, valid while `bCompiled`
+
+	delta_SProfileCounts	opcodeProfile[OPCODE_COUNT]; // See `DELTA_STATE_PROFILE`, the lines have theirs
+
+	volatile sig_atomic_t	bSampleRequested; // See `delta_RequestSample`
+	delta_SSampleVector		samples;
 };
 
 // ******************************************************************************** //
 
 /**
+ * Binary search of line `number` in `D->lineVector`
+ *
+ * \param[out] index of the line, or where it would be inserted if it doesn't exist
+ */
+delta_TBool			delta_FindLine(const delta_SState* D, size_t number, size_t* index);
+
+/**
+ * Insert or replace the line `lineNumber`, the program has to be compiled again
+ *
  * \param strSize size of string with a null-terminal
  */
 delta_TBool			delta_InsertLine(delta_SState* D, size_t lineNumber, const delta_TChar str[], size_t strSize);
 
 /**
- * delta_RemoveLine
+ * Remove the line `line` if it exists, the program has to be compiled again
  */
 void				delta_RemoveLine(delta_SState* D, size_t line);
 
@@ -196,8 +401,18 @@ void				delta_RemoveLine(delta_SState* D, size_t line);
  */
 void				delta_FreeNode(delta_SState* D, delta_SLine* line);
 
+/**
+ * The exec line can run: it's the current line, or a `RETURN` or `NEXT` goes back to it
+ */
+delta_TBool			delta_IsExecLineLive(const delta_SState* D);
+
 // ******************************************************************************** //
 
+/**
+ * Free the entries of `table`, not the values
+ */
+void				delta_FreeNameTable(delta_SState* D, delta_SNameTable* table, delta_EMemoryCategory category);
+
 /**
  * \param size size of name in string with a null-terminal
  */
@@ -206,7 +421,7 @@ delta_SNumericVariable* delta_FindOrAddNumericVariable(delta_SState* D, const de
 /**
  * delta_FreeNumericVariable
  *
- * Only free the variable. Doesn't fix the list
+ * Only free the variable. Doesn't fix the list and doesn't touch its slot
  */
 void				delta_FreeNumericVariable(delta_SState* D, delta_SNumericVariable* variable);
 
@@ -222,7 +437,7 @@ delta_SStringVariable* delta_FindOrAddStringVariable(delta_SState* D, const delt
 /**
  * delta_FreeStringVariable
  *
- * Only free the variable. Doesn't fix the list
+ * Only free the variable. Doesn't fix the list and doesn't touch its slot
  */
 void				delta_FreeStringVariable(delta_SState* D, delta_SStringVariable* variable);
 
@@ -260,6 +475,11 @@ void				delta_FreeStringArray(delta_SState* D, delta_SStringArray* array);
 
 // ******************************************************************************** //
 
+/**
+ * Append `function` to `D->cfuncVector`. Its name must not be registered yet
+ */
+delta_TBool			delta_AddCFunction(delta_SState* D, delta_SCFunction* function);
+
 /**
  * delta_FindCFunction
  */
@@ -272,9 +492,67 @@ void				delta_FreeCFunction(delta_SState* D, delta_SCFunction* function);
 
 // ******************************************************************************** //
 
+/**
+ * Sample of the folded stack [`str`; `str + size`), added with a zero count if it's new
+ */
+delta_SSample*		delta_FindOrAddSample(delta_SState* D, const delta_TChar str[], uint16_t size);
+
+/**
+ * Free the samples and their table
+ */
+void				delta_FreeSamples(delta_SState* D);
+
+// ******************************************************************************** //
+
 /**
  * delta_FreeStringStack
  */
 void				delta_FreeStringStack(delta_SState* D);
 
+// ******************************************************************************** //
+
+/**
+ * Free the strings kept by `D->stringPool`
+ */
+void				delta_FreeStringPool(delta_SState* D);
+
+/**
+ * Set `value` to a copy of [`str`; `str + size`). `value` must not hold a string
+ *
+ * \return `dfalse` on allocation failure
+ */
+delta_TBool			delta_CreateStringValue(delta_SState* D, delta_UStringValue* value, const delta_TChar str[], size_t size);
+
+/**
+ * Add a reference to the heap string of `value`, if any. Used when `value` is copied
+ */
+void				delta_RetainStringValue(const delta_UStringValue* value);
+
+/**
+ * Drop the string of `value`, heap strings are freed with their last reference. `value` is left empty
+ */
+void				delta_ReleaseStringValue(delta_SState* D, delta_UStringValue* value);
+
+/**
+ * Resize `value` to `size` characters, keeping the first ones. A shared heap string is
+ * copied, otherwise it grows in place with a geometric capacity
+ *
+ * \return `dfalse` on allocation failure, `value` is left untouched
+ */
+delta_TBool			delta_ResizeStringValue(delta_SState* D, delta_UStringValue* value, size_t size);
+
+// ******************************************************************************** //
+
+/**
+ * Intern [`str`; `str + size`)
+ *
+ * \return `dfalse` on allocation failure or if `DELTA_STRING_CONSTANT_INDEX_MASK` is exceeded
+ */
+delta_TBool			delta_AddStringConstant(delta_SState* D, delta_SStringConstants* constants, const delta_TChar str[], size_t size, size_t* index);
+
+/**
+ * Free the interned strings, and the pool itself if `bRelease`
+ */
+void				delta_ClearStringConstants(delta_SState* D, delta_SStringConstants* constants, delta_TBool bRelease);
+
 #endif /* !__DELTABASIC_STATE_H__ */
\ No newline at end of file
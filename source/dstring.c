@@ -23,3 +23,16 @@ size_t delta_Strlen(const delta_TChar str[]) {
 int delta_Strncmp(const delta_TChar strA[], const delta_TChar strB[], size_t n) {
 	return strncmp(strA, strB, n);
 }
+
+/* ****************************************
+ * delta_Hash
+ */
+uint32_t delta_Hash(const delta_TChar str[], size_t size) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= (uint32_t)(unsigned char)str[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
@@ -8,6 +8,7 @@
 #define __DELTABASIC_STRING_H__
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "deltabasic.h"
 
@@ -23,4 +24,9 @@ size_t delta_Strlen(const delta_TChar str[]);
  */
 int delta_Strncmp(const delta_TChar strA[], const delta_TChar strB[], size_t n);
 
+/**
+ * FNV-1a hash of `size` characters of `str`
+ */
+uint32_t delta_Hash(const delta_TChar str[], size_t size);
+
 #endif /* !__DELTABASIC_STRING_H__ */
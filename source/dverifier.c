@@ -0,0 +1,326 @@
+/**
+ * \file	dverifier.c
+ * \brief	Bytecode verifier, see `delta_VerifyLine`
+ * \date	17 oct 2026
+ * \author	Reklov
+ */
+#include "dverifier.h"
+
+#include "dstring.h"
+#include "dopcodes.h"
+
+#define DELTA_VERIFIER_BOUNDARY								0x01 // Stacks back to their start height after the instruction
+
+// ******************************************************************************** //
+
+/**
+ * delta_SStackEffect
+ *
+ * Values taken then pushed by an instruction
+ */
+typedef struct delta_SStackEffect {
+	delta_TByte		numericPop;
+	delta_TByte		numericPush;
+	delta_TByte		stringPop;
+	delta_TByte		stringPush;
+	delta_TByte		flags; // `DELTA_VERIFIER_BOUNDARY`
+} delta_SStackEffect;
+
+/**
+ * Stack effects of the opcodes, `OPCODE_CONCATN`, `OPCODE_APPENDS`, `OPCODE_CALL` and `OPCODE_CALLR`
+ * depend on their operands
+ */
+static const delta_SStackEffect stack_effects[OPCODE_COUNT] = {
+	[OPCODE_HLT]		= { 0, 0, 0, 0, DELTA_VERIFIER_BOUNDARY },
+	[OPCODE_NEXTL]		= { 0, 0, 0, 0, DELTA_VERIFIER_BOUNDARY },
+	[OPCODE_PUSHS]		= { 0, 0, 0, 1, 0 },
+	[OPCODE_PUSHN]		= { 0, 1, 0, 0, 0 },
+	[OPCODE_CONCAT]		= { 0, 0, 2, 1, 0 },
+	[OPCODE_ADD]		= { 2, 1, 0, 0, 0 },
+	[OPCODE_SUB]		= { 2, 1, 0, 0, 0 },
+	[OPCODE_MUL]		= { 2, 1, 0, 0, 0 },
+	[OPCODE_DIV]		= { 2, 1, 0, 0, 0 },
+	[OPCODE_MOD]		= { 2, 1, 0, 0, 0 },
+	[OPCODE_POW]		= { 2, 1, 0, 0, 0 },
+	[OPCODE_SETN]		= { 1, 0, 0, 0, 0 },
+	[OPCODE_SETS]		= { 0, 0, 1, 0, 0 },
+	[OPCODE_JMP]		= { 0, 0, 0, 0, DELTA_VERIFIER_BOUNDARY },
+	[OPCODE_PRINTN]		= { 1, 0, 0, 0, 0 },
+	[OPCODE_PRINTNT]	= { 1, 0, 0, 0, 0 },
+	[OPCODE_PRINTS]		= { 0, 0, 1, 0, 0 },
+	[OPCODE_PRINTST]	= { 0, 0, 1, 0, 0 },
+	[OPCODE_PRINTLN]	= { 0, 0, 0, 0, 0 },
+	[OPCODE_GETN]		= { 0, 1, 0, 0, 0 },
+	[OPCODE_GETS]		= { 0, 0, 0, 1, 0 },
+	[OPCODE_ET]			= { 2, 1, 0, 0, 0 },
+	[OPCODE_NET]		= { 2, 1, 0, 0, 0 },
+	[OPCODE_LT]			= { 2, 1, 0, 0, 0 },
+	[OPCODE_GT]			= { 2, 1, 0, 0, 0 },
+	[OPCODE_LET]		= { 2, 1, 0, 0, 0 },
+	[OPCODE_GET]		= { 2, 1, 0, 0, 0 },
+	[OPCODE_NEG]		= { 1, 1, 0, 0, 0 },
+	[OPCODE_STOP]		= { 0, 0, 0, 0, DELTA_VERIFIER_BOUNDARY },
+	[OPCODE_RUN]		= { 0, 0, 0, 0, DELTA_VERIFIER_BOUNDARY },
+	[OPCODE_GOSUB]		= { 0, 0, 0, 0, DELTA_VERIFIER_BOUNDARY },
+	[OPCODE_RETURN]		= { 0, 0, 0, 0, DELTA_VERIFIER_BOUNDARY },
+	[OPCODE_JNLNZ]		= { 1, 0, 0, 0, DELTA_VERIFIER_BOUNDARY },
+	[OPCODE_SETFOR]		= { 2, 0, 0, 0, DELTA_VERIFIER_BOUNDARY },
+	[OPCODE_SETSTEPFOR]	= { 3, 0, 0, 0, DELTA_VERIFIER_BOUNDARY },
+	[OPCODE_NEXTFOR]	= { 0, 0, 0, 0, DELTA_VERIFIER_BOUNDARY },
+	[OPCODE_INPUTN]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_INPUTS]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_ALLOCN]		= { 1, 0, 0, 0, 0 },
+	[OPCODE_ALLOCS]		= { 1, 0, 0, 0, 0 },
+	[OPCODE_GETIN]		= { 1, 1, 0, 0, 0 },
+	[OPCODE_GETIS]		= { 1, 0, 0, 1, 0 },
+	[OPCODE_SETIN]		= { 2, 0, 0, 0, 0 },
+	[OPCODE_SETIS]		= { 1, 0, 1, 0, 0 },
+	[OPCODE_CALL]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_CALLR]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_INCN]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_SETNC]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_JNLNC]		= { 0, 0, 0, 0, DELTA_VERIFIER_BOUNDARY },
+	[OPCODE_JNLNN]		= { 0, 0, 0, 0, DELTA_VERIFIER_BOUNDARY },
+	[OPCODE_PRINTVN]	= { 0, 0, 0, 0, 0 },
+	[OPCODE_PRINTVNT]	= { 0, 0, 0, 0, 0 },
+	[OPCODE_PRINTVS]	= { 0, 0, 0, 0, 0 },
+	[OPCODE_PRINTVST]	= { 0, 0, 0, 0, 0 },
+	[OPCODE_RMOV]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_RNEG]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_RADD]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_RSUB]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_RMUL]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_RDIV]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_RMOD]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_RPOW]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_RET]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_RNET]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_RLT]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_RGT]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_RLET]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_RGET]		= { 0, 0, 0, 0, 0 },
+	[OPCODE_RPUSH]		= { 0, 1, 0, 0, 0 },
+	[OPCODE_RJNLZ]		= { 0, 0, 0, 0, DELTA_VERIFIER_BOUNDARY },
+	[OPCODE_CONCATN]	= { 0, 0, 0, 0, 0 },
+	[OPCODE_APPENDS]	= { 0, 0, 0, 0, 0 },
+};
+
+// ******************************************************************************** //
+
+/**
+ * Register operand in range of its bank, the exec constants only for the exec line
+ */
+static delta_TBool	IsRegisterValid(const delta_SState* D, const delta_SLine* line, delta_TWord operand);
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * delta_VerifyLine
+ */
+delta_TBool delta_VerifyLine(delta_SState* D, const delta_TByte* bytecode, const delta_SLine* line, size_t begin, size_t end, delta_SVerification* V) {
+	const size_t textSize = delta_Strlen(line->str);
+	const delta_TBool bExec = (line == D->execLine);
+
+	size_t numericHead	= 0; // Above the heads found at the start of the line
+	size_t stringHead	= 0;
+	delta_TBool bVerified = dtrue;
+
+	size_t ip = begin;
+	delta_TByte opcode = OPCODE_HLT;
+	while (ip < end) {
+		opcode = bytecode[ip];
+
+		const size_t size = delta_GetOpcodeSize(opcode);
+		if ((size == 0) || (size > end - ip))
+			return dfalse;
+
+		const delta_TByte* operands = bytecode + ip + 1;
+		const delta_TWord word = (size >= 3) ? *((const delta_TWord*)operands) : 0;
+
+		delta_SStackEffect effect = stack_effects[opcode];
+
+		switch (opcode) {
+			case OPCODE_PUSHS:
+				if ((word & DELTA_STRING_CONSTANT_EXEC) != 0) {
+					if ((bExec == dfalse) || ((word & DELTA_STRING_CONSTANT_INDEX_MASK) >= D->execStringConstants.size))
+						return dfalse;
+				}
+				else if (word >= D->stringConstants.size) {
+					return dfalse;
+				}
+				break;
+
+			case OPCODE_SETN:
+			case OPCODE_GETN:
+			case OPCODE_SETFOR:
+			case OPCODE_SETSTEPFOR:
+			case OPCODE_INPUTN:
+			case OPCODE_INCN:
+			case OPCODE_SETNC:
+			case OPCODE_PRINTVN:
+			case OPCODE_PRINTVNT:
+				if (word >= D->numericSlots.size)
+					return dfalse;
+				break;
+
+			case OPCODE_SETS:
+			case OPCODE_GETS:
+			case OPCODE_INPUTS:
+			case OPCODE_PRINTVS:
+			case OPCODE_PRINTVST:
+				if (word >= D->stringSlots.size)
+					return dfalse;
+				break;
+
+			case OPCODE_APPENDS:
+				if ((word >= D->stringSlots.size) || (operands[2] == 0))
+					return dfalse;
+
+				effect.stringPop = operands[2];
+				break;
+
+			case OPCODE_CONCATN:
+				if (operands[0] == 0)
+					return dfalse;
+
+				effect.stringPop	= operands[0];
+				effect.stringPush	= 1;
+				break;
+
+			case OPCODE_JMP:
+			case OPCODE_GOSUB: // Line index, written by `delta_Link`
+				if (*((const delta_TDWord*)(operands + 4)) >= D->lineVector.size)
+					return dfalse;
+				break;
+
+			case OPCODE_JNLNN:
+				if (*((const delta_TWord*)(operands + 3)) >= D->numericSlots.size)
+					return dfalse;
+				// fallthrough
+			case OPCODE_JNLNC:
+				if ((word >= D->numericSlots.size) || (operands[2] < OPCODE_ET) || (operands[2] > OPCODE_GET))
+					return dfalse;
+				break;
+
+			case OPCODE_ALLOCN:
+			case OPCODE_ALLOCS:
+			case OPCODE_GETIN:
+			case OPCODE_GETIS:
+			case OPCODE_SETIN:
+			case OPCODE_SETIS: // Array name in the text of the line
+				if ((size_t)word + *((const delta_TWord*)(operands + 2)) > textSize)
+					return dfalse;
+				break;
+
+			case OPCODE_CALL:
+			case OPCODE_CALLR: {
+				if (word >= D->cfuncVector.size)
+					return dfalse;
+
+				const delta_SCFunction* func = D->cfuncVector.array[word];
+				for (delta_TByte i = 0; i < func->argCount; ++i) {
+					if (((func->argsMask >> i) & 0x01) == DELTA_CFUNC_ARG_STRING)
+						++(effect.stringPop);
+					else
+						++(effect.numericPop);
+				}
+
+				if (opcode == OPCODE_CALLR) {
+					if (func->retType == DELTA_CFUNC_ARG_STRING)
+						effect.stringPush = 1;
+					else
+						effect.numericPush = 1;
+				}
+				break;
+			}
+
+			case OPCODE_RADD:
+			case OPCODE_RSUB:
+			case OPCODE_RMUL:
+			case OPCODE_RDIV:
+			case OPCODE_RMOD:
+			case OPCODE_RPOW:
+			case OPCODE_RET:
+			case OPCODE_RNET:
+			case OPCODE_RLT:
+			case OPCODE_RGT:
+			case OPCODE_RLET:
+			case OPCODE_RGET:
+				if (IsRegisterValid(D, line, *((const delta_TWord*)(operands + 4))) == dfalse)
+					return dfalse;
+				// fallthrough
+			case OPCODE_RMOV:
+			case OPCODE_RNEG:
+				if (IsRegisterValid(D, line, *((const delta_TWord*)(operands + 2))) == dfalse)
+					return dfalse;
+				// fallthrough
+			case OPCODE_RPUSH:
+			case OPCODE_RJNLZ:
+				if (IsRegisterValid(D, line, word) == dfalse)
+					return dfalse;
+				break;
+
+			default:
+				break;
+		}
+
+		// Stack heads, from here the segment is valid whatever they do
+		if ((effect.numericPop > numericHead) || (effect.stringPop > stringHead)) {
+			bVerified = dfalse;
+		}
+		else {
+			numericHead	= numericHead - effect.numericPop + effect.numericPush;
+			stringHead	= stringHead - effect.stringPop + effect.stringPush;
+
+			if (((effect.flags & DELTA_VERIFIER_BOUNDARY) != 0) && ((numericHead != 0) || (stringHead != 0)))
+				bVerified = dfalse;
+
+			V->numericDepth	= DELTABASIC_MAX(V->numericDepth, numericHead);
+			V->stringDepth	= DELTABASIC_MAX(V->stringDepth, stringHead);
+		}
+
+		ip += size;
+	}
+
+	if (bVerified == dfalse)
+		V->bVerified = dfalse;
+
+	return (opcode == OPCODE_NEXTL);
+}
+
+/* ****************************************
+ * delta_VerifyProgram
+ */
+delta_TBool delta_VerifyProgram(delta_SState* D) {
+	delta_SVerification* V = &(D->verification);
+	V->bVerified	= dtrue;
+	V->numericDepth	= 0;
+	V->stringDepth	= 0;
+
+	for (delta_SLine* line = D->head; line != NULL; line = line->next) {
+		if (delta_VerifyLine(D, D->bytecode, line, line->offset, line->offset + line->bytecodeSize, V) == dfalse) {
+			V->bVerified = dfalse;
+			return dfalse;
+		}
+	}
+
+	return dtrue;
+}
+
+// ******************************************************************************** //
+
+/* ****************************************
+ * IsRegisterValid
+ */
+delta_TBool IsRegisterValid(const delta_SState* D, const delta_SLine* line, delta_TWord operand) {
+	const size_t index = operand & DELTA_REGISTER_INDEX_MASK;
+
+	switch (operand >> DELTA_REGISTER_BANK_SHIFT) {
+		case DELTA_REGISTER_VARIABLES:			return (index < D->numericSlots.size);
+		case DELTA_REGISTER_TEMPS:				return (index < DELTABASIC_MACHINE_REGISTER_TEMPS);
+		case DELTA_REGISTER_CONSTANTS:			return (index < D->registerConstants.size);
+		case DELTA_REGISTER_EXEC_CONSTANTS:		return ((line == D->execLine) && (index < D->execConstantsSize));
+		default:
+			return dfalse;
+	}
+}
@@ -0,0 +1,36 @@
+/**
+ * \file	dverifier.h
+ * \brief	Bytecode verifier, see `delta_VerifyLine`
+ * \date	17 oct 2026
+ * \author	Reklov
+ */
+#ifndef __DELTABASIC_VERIFIER_H__
+#define __DELTABASIC_VERIFIER_H__
+
+#include "deltabasic.h"
+#include "dstate.h"
+#include "dlimits.h"
+
+// ******************************************************************************** //
+
+/**
+ * Check that the segment [`begin`; `end`) of `line` in `bytecode` is made of whole instructions
+ * with operands in range of `D`, jumps to existing lines, ending with `OPCODE_NEXTL`.
+ *
+ * Then follow the stack heads through the segment: `V->bVerified` is cleared if an instruction
+ * can take more than the line pushed, or if the stacks aren't back to their start height where
+ * the VM can leave the line or come back into it (`OPCODE_GOSUB`, `OPCODE_SETFOR`, ...).
+ * Otherwise the depths of `V` are raised to those of the line
+ *
+ * \return dfalse if the segment is invalid
+ */
+delta_TBool			delta_VerifyLine(delta_SState* D, const delta_TByte* bytecode, const delta_SLine* line, size_t begin, size_t end, delta_SVerification* V);
+
+/**
+ * Verify every line of the compiled program into `D->verification`
+ *
+ * \return dfalse if a segment is invalid
+ */
+delta_TBool			delta_VerifyProgram(delta_SState* D);
+
+#endif /* !__DELTABASIC_VERIFIER_H__ */